@@ -0,0 +1,153 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_AST_SNAPSHOT_HPP_INCLUDED
+#define STANDARDESE_AST_SNAPSHOT_HPP_INCLUDED
+
+#include <cassert>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <standardese/cpp_entity.hpp>
+#include <standardese/shared_string.hpp>
+
+namespace standardese
+{
+    class cpp_file;
+
+    /// An immutable, flat view of the entities of a file.
+    /// Entities are stored in breadth-first order in a couple of arrays,
+    /// all strings are in a single pool.
+    /// The children of an entity are contiguous, the file (or entity) it was created from is always at index 0.
+    /// Members of class templates and specializations are children of the template,
+    /// function and template parameters are not part of the snapshot.
+    /// The file and each documented entity also store their rendered synopsis,
+    /// so a snapshot can be saved and used for generation without libclang.
+    class ast_snapshot
+    {
+    public:
+        using index = std::uint32_t;
+
+        static const index no_parent = index(-1);
+
+        /// Creates the snapshot of a file.
+        /// The file must outlive the snapshot.
+        explicit ast_snapshot(const cpp_file &f);
+
+        /// Creates the snapshot of a single entity and its members,
+        /// e.g. to generate its documentation without rendering the rest of the file.
+        /// The entity must outlive the snapshot.
+        explicit ast_snapshot(const cpp_entity &e);
+
+        /// Loads a snapshot written by save() by reading the file into memory once,
+        /// all strings are views into that buffer.
+        /// Throws std::runtime_error if the file can't be read or has a different format version.
+        static ast_snapshot load(const char *path);
+
+        /// Writes the snapshot in a binary format.
+        void save(std::ostream &out) const;
+
+        std::size_t size() const STANDARDESE_NOEXCEPT
+        {
+            return size_;
+        }
+
+        cpp_entity::type get_entity_type(index i) const STANDARDESE_NOEXCEPT
+        {
+            return cpp_entity::type(kinds_[i]);
+        }
+
+        /// Returns the parent index or no_parent for the file.
+        index get_parent(index i) const STANDARDESE_NOEXCEPT
+        {
+            return parents_[i];
+        }
+
+        /// Returns the index of the first child.
+        index children_begin(index i) const STANDARDESE_NOEXCEPT
+        {
+            return first_child_[i];
+        }
+
+        /// Returns the index one past the last child.
+        index children_end(index i) const STANDARDESE_NOEXCEPT
+        {
+            return first_child_[i + 1];
+        }
+
+        shared_string get_name(index i) const STANDARDESE_NOEXCEPT
+        {
+            return get_string(names_[i]);
+        }
+
+        shared_string get_scope(index i) const STANDARDESE_NOEXCEPT
+        {
+            return get_string(scopes_[i]);
+        }
+
+        shared_string get_comment(index i) const STANDARDESE_NOEXCEPT
+        {
+            return get_string(comments_[i]);
+        }
+
+        /// Returns the synopsis without the surrounding code block,
+        /// empty for entities without documentation.
+        shared_string get_synopsis(index i) const STANDARDESE_NOEXCEPT
+        {
+            return get_string(synopsis_[i]);
+        }
+
+        /// Returns whether or not the snapshot was created from the entities,
+        /// i.e. it wasn't loaded.
+        bool has_entities() const STANDARDESE_NOEXCEPT
+        {
+            return !entities_.empty();
+        }
+
+        /// Returns the entity the entry was created from.
+        const cpp_entity& get_entity(index i) const STANDARDESE_NOEXCEPT
+        {
+            assert(has_entities());
+            return *entities_[i];
+        }
+
+    private:
+        struct span
+        {
+            std::uint32_t offset, length;
+        };
+
+        ast_snapshot(std::shared_ptr<const char> block, std::size_t size, std::size_t block_size);
+
+        // sets the array pointers into the block
+        void init(std::shared_ptr<const char> block, std::size_t size, std::size_t block_size);
+
+        shared_string get_string(const span &s) const STANDARDESE_NOEXCEPT
+        {
+            return shared_string(data_, pool_ + s.offset, s.length);
+        }
+
+        // one block holding all arrays followed by the string pool
+        std::shared_ptr<const char> data_;
+        std::size_t size_, block_size_;
+
+        const index *parents_, *first_child_;
+        const span *names_, *scopes_, *comments_, *synopsis_;
+        const std::uint8_t *kinds_;
+        const char *pool_;
+
+        std::vector<const cpp_entity*> entities_;
+    };
+
+    /// Returns the first entity of the file whose scope and name are full_name (e.g. "ns::a::f"),
+    /// in the order of its snapshot, or nullptr if there is none.
+    /// Only the entities that would be part of the snapshot are searched,
+    /// without creating one.
+    const cpp_entity* find_entity(const cpp_file &f, const std::string &full_name);
+} // namespace standardese
+
+#endif // STANDARDESE_AST_SNAPSHOT_HPP_INCLUDED
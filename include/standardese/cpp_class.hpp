@@ -9,6 +9,11 @@
 
 namespace standardese
 {
+    namespace detail
+    {
+        class declaration;
+    } // namespace detail
+
     enum cpp_access_specifier_t
     {
         cpp_private,
@@ -40,15 +45,17 @@ namespace standardese
     : public cpp_entity
     {
     public:
-        static cpp_ptr<cpp_base_class> parse(cpp_name scope, cpp_cursor cur);
+        static cpp_ptr<cpp_base_class> parse(shared_string scope, cpp_cursor cur);
 
-        cpp_base_class(cpp_name scope,
+        cpp_base_class(shared_string scope,
                        cpp_name name, CXType type,
                        cpp_access_specifier_t access,
                        bool is_virtual)
         : cpp_entity(base_class_t, std::move(scope), std::move(name), ""), type_(type), access_(access),
           virtual_(is_virtual) {}
 
+        /// Returns the libclang type of the base,
+        /// only valid as long as the translation unit is alive.
         CXType get_type() const STANDARDESE_NOEXCEPT
         {
             return type_;
@@ -84,7 +91,10 @@ namespace standardese
         class parser : public cpp_entity_parser
         {
         public:
-            parser(cpp_name scope, cpp_cursor cur);
+            parser(shared_string scope, cpp_cursor cur);
+
+            /// Same as above but reuses the parsed declaration of the cursor.
+            parser(shared_string scope, cpp_cursor cur, const detail::declaration &decl);
 
             void add_entity(cpp_entity_ptr ptr) override;
 
@@ -92,14 +102,21 @@ namespace standardese
 
             cpp_entity_ptr finish(const standardese::parser &par) override;
 
+            /// Returns the comment of the class, for reuse by template wrappers.
+            /// Empty if it is only a declaration.
+            cpp_raw_comment get_comment() const STANDARDESE_NOEXCEPT
+            {
+                return class_ ? class_->get_comment() : cpp_raw_comment();
+            }
+
         private:
             cpp_ptr<cpp_class> class_;
         };
 
-        cpp_class(cpp_name scope, cpp_name name, cpp_raw_comment comment,
+        cpp_class(shared_string scope, cpp_name name, cpp_raw_comment comment,
                   CXType type, cpp_class_type ctype, bool is_final)
         : cpp_type(class_t, std::move(scope), std::move(name), std::move(comment), type),
-          type_(ctype), final_(is_final) {}
+          cpp_entity_container(this), type_(ctype), final_(is_final) {}
 
         void add_entity(cpp_entity_ptr e)
         {
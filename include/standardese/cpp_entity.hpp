@@ -5,6 +5,8 @@
 #ifndef STANDARDESE_CPP_ENTITY_HPP_INCLUDED
 #define STANDARDESE_CPP_ENTITY_HPP_INCLUDED
 
+#include <atomic>
+#include <cassert>
 #include <cstddef>
 #include <iterator>
 #include <memory>
@@ -12,6 +14,7 @@
 #include <type_traits>
 
 #include <standardese/noexcept.hpp>
+#include <standardese/shared_string.hpp>
 
 namespace standardese
 {
@@ -19,7 +22,9 @@ namespace standardese
     class cpp_entity_container;
 
     using cpp_name = std::string;
-    using cpp_raw_comment = std::string;
+
+    /// Comments are shared, i.e. template wrappers and their entity use the same storage.
+    using cpp_raw_comment = shared_string;
 
     class cpp_entity
     {
@@ -73,7 +78,10 @@ namespace standardese
         cpp_entity(cpp_entity&&) = delete;
         cpp_entity(const cpp_entity&) = delete;
 
-        virtual ~cpp_entity() STANDARDESE_NOEXCEPT = default;
+        virtual ~cpp_entity() STANDARDESE_NOEXCEPT
+        {
+            delete unique_name_.load();
+        }
 
         cpp_entity& operator=(const cpp_entity&) = delete;
         cpp_entity& operator=(cpp_entity&&) = delete;
@@ -83,13 +91,16 @@ namespace standardese
             return name_;
         }
 
-        virtual cpp_name get_unique_name() const
+        /// Returns the name including all scopes.
+        /// It is computed on the first call only.
+        const cpp_name& get_unique_name() const
         {
-            return scope_.empty() ? name_ : scope_ + "::" + name_;
+            auto name = unique_name_.load(std::memory_order_acquire);
+            return name ? *name : cache_unique_name();
         }
 
         // excluding trailing "::"
-        const cpp_name& get_scope() const STANDARDESE_NOEXCEPT
+        const shared_string& get_scope() const STANDARDESE_NOEXCEPT
         {
             return scope_;
         }
@@ -104,30 +115,64 @@ namespace standardese
             return t_;
         }
 
+        /// Returns the entity this entity is a member of,
+        /// or nullptr if it doesn't belong to one.
+        const cpp_entity* get_parent() const STANDARDESE_NOEXCEPT
+        {
+            return parent_;
+        }
+
     protected:
-        cpp_entity(type t, cpp_name scope, cpp_name n, cpp_raw_comment c) STANDARDESE_NOEXCEPT
+        cpp_entity(type t, shared_string scope, cpp_name n, cpp_raw_comment c) STANDARDESE_NOEXCEPT
         : name_(std::move(n)), scope_(std::move(scope)), comment_(std::move(c)),
-          next_(nullptr), t_(t)
+          next_(nullptr), parent_(nullptr), unique_name_(nullptr), t_(t)
         {}
 
+        // must be called before the unique name is used
         void set_name(cpp_name n)
         {
+            assert(!unique_name_.load());
             name_ = std::move(n);
         }
 
+        // for entities owning another entity without being a container
+        static void set_parent(cpp_entity &e, const cpp_entity &parent) STANDARDESE_NOEXCEPT
+        {
+            e.parent_ = &parent;
+        }
+
         void set_type(type t) STANDARDESE_NOEXCEPT
         {
             t_ = t;
         }
 
     private:
-        cpp_name name_, scope_;
+        cpp_name name_;
+        shared_string scope_;
         cpp_raw_comment comment_;
 
         std::unique_ptr<cpp_entity> next_;
+        const cpp_entity *parent_;
+
+        mutable std::atomic<const cpp_name*> unique_name_;
 
         type t_;
 
+        const cpp_name& cache_unique_name() const
+        {
+            auto name = new cpp_name(scope_.empty() ? name_ : scope_.str() + "::" + name_);
+
+            const cpp_name *expected = nullptr;
+            if (!unique_name_.compare_exchange_strong(expected, name, std::memory_order_acq_rel))
+            {
+                // other thread was faster
+                delete name;
+                return *expected;
+            }
+
+            return *name;
+        }
+
         template <typename T>
         friend class cpp_entity_container;
     };
@@ -224,13 +269,19 @@ namespace standardese
 
     protected:
         cpp_entity_container() STANDARDESE_NOEXCEPT
-        : first_(nullptr), last_(nullptr) {}
+        : first_(nullptr), last_(nullptr), owner_(nullptr) {}
+
+        /// The owner will become the parent of all entities added.
+        cpp_entity_container(const cpp_entity *owner) STANDARDESE_NOEXCEPT
+        : first_(nullptr), last_(nullptr), owner_(owner) {}
 
         void add_entity(cpp_ptr<T> entity)
         {
             if (!entity)
                 return;
 
+            entity->parent_ = owner_;
+
             if (last_)
             {
                 last_->next_ = std::move(entity);
@@ -246,6 +297,7 @@ namespace standardese
     private:
         cpp_entity_ptr first_;
         cpp_entity *last_;
+        const cpp_entity *owner_;
     };
 
     class parser;
@@ -13,9 +13,9 @@ namespace standardese
     : public cpp_entity
     {
     public:
-        static cpp_ptr<cpp_enum_value> parse(cpp_name scope, cpp_cursor cur);
+        static cpp_ptr<cpp_enum_value> parse(shared_string scope, cpp_cursor cur);
 
-        cpp_enum_value(cpp_name scope, cpp_name name, cpp_raw_comment comment)
+        cpp_enum_value(shared_string scope, cpp_name name, cpp_raw_comment comment)
         : cpp_enum_value(enum_value_t, std::move(scope), std::move(name), std::move(comment)) {}
 
         bool is_explicitly_given() const STANDARDESE_NOEXCEPT
@@ -24,7 +24,7 @@ namespace standardese
         }
 
     protected:
-        cpp_enum_value(cpp_entity::type t, cpp_name scope,
+        cpp_enum_value(cpp_entity::type t, shared_string scope,
                        cpp_name name, cpp_raw_comment comment)
         : cpp_entity(t, std::move(scope), std::move(name), std::move(comment)),
           explicit_(false) {}
@@ -37,7 +37,7 @@ namespace standardese
     : public cpp_enum_value
     {
     public:
-        cpp_signed_enum_value(cpp_name scope, cpp_name name, cpp_raw_comment comment,
+        cpp_signed_enum_value(shared_string scope, cpp_name name, cpp_raw_comment comment,
                               long long value)
         : cpp_enum_value(signed_enum_value_t, std::move(scope),
                          std::move(name), std::move(comment)),
@@ -56,7 +56,7 @@ namespace standardese
     : public cpp_enum_value
     {
     public:
-        cpp_unsigned_enum_value(cpp_name scope, cpp_name name, cpp_raw_comment comment,
+        cpp_unsigned_enum_value(shared_string scope, cpp_name name, cpp_raw_comment comment,
                                 unsigned long long value)
         : cpp_enum_value(unsigned_enum_value_t, std::move(scope),
                          std::move(name), std::move(comment)),
@@ -79,7 +79,7 @@ namespace standardese
         : public cpp_entity_parser
         {
         public:
-            parser(cpp_name scope, cpp_cursor cur);
+            parser(shared_string scope, cpp_cursor cur);
 
             void add_entity(cpp_entity_ptr ptr) override;
 
@@ -91,10 +91,10 @@ namespace standardese
             cpp_ptr<cpp_enum> enum_;
         };
 
-        cpp_enum(cpp_name scope, cpp_name name, cpp_raw_comment comment,
+        cpp_enum(shared_string scope, cpp_name name, cpp_raw_comment comment,
                  CXType type, cpp_type_ref underlying)
         : cpp_type(enum_t, std::move(scope), std::move(name), std::move(comment), type),
-          underlying_(std::move(underlying)),
+          cpp_entity_container(this), underlying_(std::move(underlying)),
           is_scoped_(false) {}
 
         void add_enum_value(cpp_ptr<cpp_enum_value> value)
@@ -12,6 +12,11 @@
 
 namespace standardese
 {
+    namespace detail
+    {
+        class declaration;
+    } // namespace detail
+
     class cpp_function_parameter
     : public cpp_parameter_base
     {
@@ -75,7 +80,11 @@ namespace standardese
     : public cpp_entity, private cpp_entity_container<cpp_function_parameter>
     {
     public:
-        static cpp_ptr<cpp_function_base> try_parse(cpp_name scope, cpp_cursor cur);
+        static cpp_ptr<cpp_function_base> try_parse(shared_string scope, cpp_cursor cur);
+
+        /// Same as above but reuses the parsed declaration of the cursor.
+        static cpp_ptr<cpp_function_base> try_parse(shared_string scope, cpp_cursor cur,
+                                                    const detail::declaration &decl);
 
         void add_parameter(cpp_ptr<cpp_function_parameter> param)
         {
@@ -122,10 +131,10 @@ namespace standardese
 
     protected:
         cpp_function_base(cpp_entity::type t,
-                          cpp_name scope, cpp_name name, cpp_raw_comment comment,
+                          shared_string scope, cpp_name name, cpp_raw_comment comment,
                           cpp_function_info info)
         : cpp_entity(t, std::move(scope), std::move(name), std::move(comment)),
-          info_(std::move(info)) {}
+          cpp_entity_container(this), info_(std::move(info)) {}
 
     private:
         cpp_function_info info_;
@@ -135,9 +144,9 @@ namespace standardese
     : public cpp_function_base
     {
     public:
-        static cpp_ptr<cpp_function> parse(cpp_name scope, cpp_cursor cur);
+        static cpp_ptr<cpp_function> parse(shared_string scope, cpp_cursor cur);
 
-        cpp_function(cpp_name scope, cpp_name name, cpp_raw_comment comment,
+        cpp_function(shared_string scope, cpp_name name, cpp_raw_comment comment,
                      cpp_type_ref return_type, cpp_function_info info)
         : cpp_function_base(function_t,
                             std::move(scope), std::move(name), std::move(comment),
@@ -212,9 +221,9 @@ namespace standardese
     : public cpp_function
     {
     public:
-        static cpp_ptr<cpp_member_function> parse(cpp_name scope, cpp_cursor cur);
+        static cpp_ptr<cpp_member_function> parse(shared_string scope, cpp_cursor cur);
 
-        cpp_member_function(cpp_name scope, cpp_name name, cpp_raw_comment comment,
+        cpp_member_function(shared_string scope, cpp_name name, cpp_raw_comment comment,
                             cpp_type_ref return_type,
                             cpp_function_info finfo, cpp_member_function_info minfo)
         : cpp_function(std::move(scope), std::move(name), std::move(comment),
@@ -247,9 +256,9 @@ namespace standardese
     : public cpp_function_base
     {
     public:
-        static cpp_ptr<cpp_conversion_op> parse(cpp_name scope, cpp_cursor cur);
+        static cpp_ptr<cpp_conversion_op> parse(shared_string scope, cpp_cursor cur);
 
-        cpp_conversion_op(cpp_name scope, cpp_name name, cpp_raw_comment comment,
+        cpp_conversion_op(shared_string scope, cpp_name name, cpp_raw_comment comment,
                           cpp_type_ref target_type,
                           cpp_function_info finfo, cpp_member_function_info minfo)
         : cpp_function_base(conversion_op_t,
@@ -286,9 +295,9 @@ namespace standardese
     : public cpp_function_base
     {
     public:
-        static cpp_ptr<cpp_constructor> parse(cpp_name scope, cpp_cursor cur);
+        static cpp_ptr<cpp_constructor> parse(shared_string scope, cpp_cursor cur);
 
-        cpp_constructor(cpp_name scope, cpp_name name, cpp_raw_comment comment,
+        cpp_constructor(shared_string scope, cpp_name name, cpp_raw_comment comment,
                         cpp_function_info info)
         : cpp_function_base(constructor_t,
                             std::move(scope), std::move(name), std::move(comment),
@@ -299,9 +308,9 @@ namespace standardese
     : public cpp_function_base
     {
     public:
-        static cpp_ptr<cpp_destructor> parse(cpp_name scope, cpp_cursor cur);
+        static cpp_ptr<cpp_destructor> parse(shared_string scope, cpp_cursor cur);
 
-        cpp_destructor(cpp_name scope, cpp_name name, cpp_raw_comment comment,
+        cpp_destructor(shared_string scope, cpp_name name, cpp_raw_comment comment,
                        cpp_function_info info, cpp_virtual virtual_flag)
         : cpp_function_base(destructor_t,
                             std::move(scope), std::move(name), std::move(comment),
@@ -19,7 +19,7 @@ namespace standardese
         class parser : public cpp_entity_parser
         {
         public:
-            parser(const cpp_name &scope, cpp_cursor cur);
+            parser(shared_string scope, cpp_cursor cur);
 
             void add_entity(cpp_entity_ptr ptr) override
             {
@@ -37,9 +37,9 @@ namespace standardese
             cpp_ptr<cpp_namespace> ns_;
         };
 
-        cpp_namespace(const cpp_name &scope, cpp_name name, cpp_raw_comment comment)
-        : cpp_entity(namespace_t, scope, std::move(name), std::move(comment)),
-          inline_(false) {}
+        cpp_namespace(shared_string scope, cpp_name name, cpp_raw_comment comment)
+        : cpp_entity(namespace_t, std::move(scope), std::move(name), std::move(comment)),
+          cpp_entity_container(this), inline_(false) {}
 
         void add_entity(cpp_entity_ptr ptr)
         {
@@ -59,9 +59,9 @@ namespace standardese
     : public cpp_entity
     {
     public:
-        static cpp_ptr<cpp_namespace_alias> parse(cpp_name scope, cpp_cursor cur);
+        static cpp_ptr<cpp_namespace_alias> parse(shared_string scope, cpp_cursor cur);
 
-        cpp_namespace_alias(cpp_name scope, cpp_name name, cpp_raw_comment comment, cpp_name target)
+        cpp_namespace_alias(shared_string scope, cpp_name name, cpp_raw_comment comment, cpp_name target)
         : cpp_entity(namespace_alias_t, std::move(scope), std::move(name), std::move(comment)),
           target_(std::move(target)), unique_(target) {}
 
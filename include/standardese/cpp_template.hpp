@@ -15,12 +15,13 @@ namespace standardese
     {
     public:
         cpp_template_ref()
-        : cpp_template_ref(cpp_cursor({}), "") {}
+        : declaration_(clang_getNullCursor()) {}
 
         /// Constructs it by giving the cursor to the template
         /// and the name as specified in the source.
-        cpp_template_ref(cpp_cursor tmplate, cpp_name given)
-        : given_(std::move(given)), declaration_(tmplate) {}
+        /// The full name is resolved immediately,
+        /// so it doesn't require the translation unit later on.
+        cpp_template_ref(cpp_cursor tmplate, cpp_name given);
 
         /// Returns the name as specified in the source.
         const cpp_name& get_name() const STANDARDESE_NOEXCEPT
@@ -29,16 +30,20 @@ namespace standardese
         }
 
         /// Returns the full name with all scopes.
-        cpp_name get_full_name() const;
+        const cpp_name& get_full_name() const STANDARDESE_NOEXCEPT
+        {
+            return full_;
+        }
 
-        /// Returns a cursor to the declaration of the template.
+        /// Returns a cursor to the declaration of the template,
+        /// only valid as long as the translation unit is alive.
         cpp_cursor get_declaration() const STANDARDESE_NOEXCEPT
         {
             return declaration_;
         }
 
     private:
-        cpp_name given_;
+        cpp_name given_, full_;
         cpp_cursor declaration_;
     };
 
@@ -132,7 +137,7 @@ namespace standardese
                                         cpp_template_ref def, bool is_variadic)
         : cpp_template_parameter(template_template_parameter_t,
                                  std::move(name), std::move(comment), is_variadic),
-          default_(std::move(def)) {}
+          cpp_entity_container(this), default_(std::move(def)) {}
 
         void add_paramter(cpp_ptr<cpp_template_parameter> param)
         {
@@ -163,7 +168,7 @@ namespace standardese
     : public cpp_entity, private cpp_entity_container<cpp_template_parameter>
     {
     public:
-        static cpp_ptr<cpp_function_template> parse(cpp_name scope, cpp_cursor cur);
+        static cpp_ptr<cpp_function_template> parse(shared_string scope, cpp_cursor cur);
 
         cpp_function_template(cpp_name template_name, cpp_ptr<cpp_function_base> ptr);
 
@@ -190,7 +195,7 @@ namespace standardese
     : public cpp_entity
     {
     public:
-        static cpp_ptr<cpp_function_template_specialization> parse(cpp_name scope, cpp_cursor cur);
+        static cpp_ptr<cpp_function_template_specialization> parse(shared_string scope, cpp_cursor cur);
 
         cpp_function_template_specialization(cpp_name template_name, cpp_ptr<cpp_function_base> ptr);
 
@@ -216,7 +221,7 @@ namespace standardese
         class parser : public cpp_entity_parser
         {
         public:
-            parser(cpp_name scope, cpp_cursor cur);
+            parser(shared_string scope, cpp_cursor cur);
 
             void add_entity(cpp_entity_ptr ptr) override
             {
@@ -253,7 +258,7 @@ namespace standardese
         }
 
     private:
-        cpp_class_template(cpp_name scope, cpp_raw_comment comment);
+        cpp_class_template(shared_string scope, cpp_raw_comment comment);
 
         cpp_ptr<cpp_class> class_;
     };
@@ -265,7 +270,7 @@ namespace standardese
         class parser : public cpp_entity_parser
         {
         public:
-            parser(cpp_name scope, cpp_cursor cur);
+            parser(shared_string scope, cpp_cursor cur);
 
             void add_entity(cpp_entity_ptr ptr) override
             {
@@ -280,6 +285,8 @@ namespace standardese
             cpp_entity_ptr finish(const standardese::parser &par) override;
 
         private:
+            parser(shared_string scope, cpp_cursor cur, const detail::declaration &decl);
+
             cpp_class::parser parser_;
             cpp_ptr<cpp_class_template_full_specialization> class_;
         };
@@ -298,7 +305,7 @@ namespace standardese
         }
 
     private:
-        cpp_class_template_full_specialization(cpp_name scope, cpp_raw_comment comment);
+        cpp_class_template_full_specialization(shared_string scope, cpp_raw_comment comment);
 
         cpp_ptr<cpp_class> class_;
         cpp_template_ref template_;
@@ -312,7 +319,7 @@ namespace standardese
         class parser : public cpp_entity_parser
         {
         public:
-            parser(cpp_name scope, cpp_cursor cur);
+            parser(shared_string scope, cpp_cursor cur);
 
             void add_entity(cpp_entity_ptr ptr) override
             {
@@ -327,6 +334,8 @@ namespace standardese
             cpp_entity_ptr finish(const standardese::parser &par) override;
 
         private:
+            parser(shared_string scope, cpp_cursor cur, const detail::declaration &decl);
+
             cpp_class::parser parser_;
             cpp_ptr<cpp_class_template_partial_specialization> class_;
         };
@@ -355,7 +364,7 @@ namespace standardese
         }
 
     private:
-        cpp_class_template_partial_specialization(cpp_name scope, cpp_raw_comment comment);
+        cpp_class_template_partial_specialization(shared_string scope, cpp_raw_comment comment);
 
         cpp_ptr<cpp_class> class_;
         cpp_template_ref template_;
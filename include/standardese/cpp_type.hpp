@@ -18,13 +18,15 @@ namespace standardese
     : public cpp_entity
     {
     public:
+        /// Returns the libclang type,
+        /// only valid as long as the translation unit is alive.
         CXType get_type() const STANDARDESE_NOEXCEPT
         {
             return type_;
         }
 
     protected:
-        cpp_type(cpp_entity::type t, cpp_name scope, cpp_name name, cpp_raw_comment comment, CXType type)
+        cpp_type(cpp_entity::type t, shared_string scope, cpp_name name, cpp_raw_comment comment, CXType type)
         : cpp_entity(t, std::move(scope), std::move(name), std::move(comment)),
           type_(type)
         {}
@@ -37,10 +39,11 @@ namespace standardese
     {
     public:
         cpp_type_ref()
-        : cpp_type_ref({}, "") {}
+        : type_({}) {}
 
-        cpp_type_ref(CXType type, cpp_name given)
-        : given_(std::move(given)), type_(type) {}
+        /// The full name is resolved immediately,
+        /// so it doesn't require the translation unit later on.
+        cpp_type_ref(CXType type, cpp_name given);
 
         /// Returns the name as specified in the source.
         const cpp_name& get_name() const STANDARDESE_NOEXCEPT
@@ -49,16 +52,20 @@ namespace standardese
         }
 
         /// Returns the full name with all scopes as libclang returns it.
-        cpp_name get_full_name() const;
+        const cpp_name& get_full_name() const STANDARDESE_NOEXCEPT
+        {
+            return full_;
+        }
 
-        /// Returns the libclang target type.
+        /// Returns the libclang target type,
+        /// only valid as long as the translation unit is alive.
         CXType get_type() const STANDARDESE_NOEXCEPT
         {
             return type_;
         }
 
     private:
-        cpp_name given_;
+        cpp_name given_, full_;
         CXType type_;
     };
 
@@ -66,9 +73,9 @@ namespace standardese
     : public cpp_type
     {
     public:
-        static cpp_ptr<cpp_type_alias> parse(const parser &p, const cpp_name &scope, cpp_cursor cur);
+        static cpp_ptr<cpp_type_alias> parse(const parser &p, shared_string scope, cpp_cursor cur);
 
-        cpp_type_alias(cpp_name scope, cpp_name name, cpp_raw_comment comment,
+        cpp_type_alias(shared_string scope, cpp_name name, cpp_raw_comment comment,
                        CXType type, cpp_type_ref target)
         : cpp_type(type_alias_t, std::move(scope), std::move(name), std::move(comment), type),
           target_(std::move(target)) {}
@@ -21,9 +21,9 @@ namespace standardese
     : public cpp_entity
     {
     public:
-        static cpp_ptr<cpp_variable> parse(cpp_name scope, cpp_cursor cur);
+        static cpp_ptr<cpp_variable> parse(shared_string scope, cpp_cursor cur);
 
-        cpp_variable(cpp_name scope, cpp_name name, cpp_raw_comment comment,
+        cpp_variable(shared_string scope, cpp_name name, cpp_raw_comment comment,
                      cpp_type_ref type, std::string initializer,
                      cpp_linkage linkage = cpp_no_linkage,
                      bool is_thread_local = false)
@@ -64,9 +64,9 @@ namespace standardese
     : public cpp_variable
     {
     public:
-        static cpp_ptr<cpp_member_variable> parse(cpp_name scope, cpp_cursor cur);
+        static cpp_ptr<cpp_member_variable> parse(shared_string scope, cpp_cursor cur);
 
-        cpp_member_variable(cpp_name scope, cpp_name name, cpp_raw_comment comment,
+        cpp_member_variable(shared_string scope, cpp_name name, cpp_raw_comment comment,
                          cpp_type_ref type, std::string initializer,
                          cpp_linkage linkage = cpp_no_linkage,
                          bool is_mutable = false, bool is_thread_local = false)
@@ -91,7 +91,7 @@ namespace standardese
     : public cpp_member_variable
     {
     public:
-        cpp_bitfield(cpp_name scope, cpp_name name, cpp_raw_comment comment,
+        cpp_bitfield(shared_string scope, cpp_name name, cpp_raw_comment comment,
                     cpp_type_ref type, std::string initializer, unsigned no,
                     cpp_linkage linkage = cpp_no_linkage,
                     bool is_mutable = false, bool is_thread_local = false)
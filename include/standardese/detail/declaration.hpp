@@ -0,0 +1,148 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_DETAIL_DECLARATION_HPP_INCLUDED
+#define STANDARDESE_DETAIL_DECLARATION_HPP_INCLUDED
+
+#include <standardese/detail/tokenizer.hpp>
+#include <standardese/cpp_entity.hpp>
+
+namespace standardese { namespace detail
+{
+    // a part of a declaration
+    class token_range
+    {
+    public:
+        using iterator = tokenizer::iterator;
+
+        token_range(iterator begin, iterator end) STANDARDESE_NOEXCEPT
+        : begin_(begin), end_(end) {}
+
+        iterator begin() const STANDARDESE_NOEXCEPT
+        {
+            return begin_;
+        }
+
+        iterator end() const STANDARDESE_NOEXCEPT
+        {
+            return end_;
+        }
+
+        bool empty() const STANDARDESE_NOEXCEPT
+        {
+            return begin_ == end_;
+        }
+
+    private:
+        iterator begin_, end_;
+    };
+
+    // the structure of a declaration:
+    // template <...> prefix name <...> (...) suffix tail
+    // it is determined once from the classified tokens of a cursor,
+    // the parsing functions then only look at the parts they need
+    class declaration
+    {
+    public:
+        using iterator = tokenizer::iterator;
+
+        // the name can consist of multiple tokens, e.g. operator()
+        // if it isn't found, the declaration is treated as unnamed
+        declaration(const tokenizer &tokens, cpp_name name);
+
+        // same as above but only for the tokens [begin, end)
+        declaration(iterator begin, iterator end, cpp_name name);
+
+        declaration(const declaration&) = delete;
+        declaration& operator=(const declaration&) = delete;
+
+        const cpp_name& get_name() const STANDARDESE_NOEXCEPT
+        {
+            return name_;
+        }
+
+        token_range get_tokens() const STANDARDESE_NOEXCEPT
+        {
+            return {begin_, end_};
+        }
+
+        // the leading template <...>
+        token_range get_template_parameters() const STANDARDESE_NOEXCEPT
+        {
+            return {begin_, prefix_};
+        }
+
+        // everything between the template parameters and the name
+        token_range get_prefix() const STANDARDESE_NOEXCEPT
+        {
+            return {prefix_, name_begin_};
+        }
+
+        // the tokens of the name, empty for an unnamed declaration
+        // which is then placed before the first =, :, ; or {
+        token_range get_name_tokens() const STANDARDESE_NOEXCEPT
+        {
+            return {name_begin_, name_end_};
+        }
+
+        // the <...> directly after the name
+        token_range get_template_arguments() const STANDARDESE_NOEXCEPT
+        {
+            return {name_end_, arguments_end_};
+        }
+
+        // the (...) after the name and template arguments
+        token_range get_parameters() const STANDARDESE_NOEXCEPT
+        {
+            return {arguments_end_, suffix_};
+        }
+
+        // everything after the parameters until the first =, :, ;, { or -> outside brackets
+        token_range get_suffix() const STANDARDESE_NOEXCEPT
+        {
+            return {suffix_, tail_};
+        }
+
+        // everything after the suffix
+        token_range get_tail() const STANDARDESE_NOEXCEPT
+        {
+            return {tail_, end_};
+        }
+
+        // returns the first occurrence of p outside brackets after the parameters,
+        // or the end of the declaration
+        iterator find(token_punctuation p) const STANDARDESE_NOEXCEPT
+        {
+            return punctuation_[p];
+        }
+
+        // whether or not there is k/p outside brackets in the prefix
+        bool has_prefix(token_keyword k) const STANDARDESE_NOEXCEPT
+        {
+            return (prefix_keywords_ & (1ul << k)) != 0u;
+        }
+
+        bool has_prefix(token_punctuation p) const STANDARDESE_NOEXCEPT
+        {
+            return (prefix_punctuation_ & (1ul << p)) != 0u;
+        }
+
+        // whether or not there is k outside brackets in the suffix
+        bool has_suffix(token_keyword k) const STANDARDESE_NOEXCEPT
+        {
+            return (suffix_keywords_ & (1ul << k)) != 0u;
+        }
+
+    private:
+        cpp_name name_;
+        iterator begin_, prefix_, name_begin_, name_end_, arguments_end_, suffix_, tail_, end_;
+        iterator punctuation_[punctuation_amp_amp + 1];
+        unsigned long prefix_keywords_, prefix_punctuation_, suffix_keywords_;
+    };
+
+    // returns the iterator after the (...), [...] or {...} starting at begin
+    tokenizer::iterator skip_brackets(tokenizer::iterator begin, tokenizer::iterator end) STANDARDESE_NOEXCEPT;
+}} // namespace standardese::detail
+
+#endif // STANDARDESE_DETAIL_DECLARATION_HPP_INCLUDED
@@ -0,0 +1,68 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_DETAIL_MAPPED_FILE_HPP_INCLUDED
+#define STANDARDESE_DETAIL_MAPPED_FILE_HPP_INCLUDED
+
+#include <ctime>
+#include <memory>
+#include <string>
+
+#include <standardese/noexcept.hpp>
+
+namespace standardese { namespace detail
+{
+    // read-only contents of a file
+    // it is read into memory once, copies and the raw comments referring to it share the buffer
+    // it isn't memory mapped, an AST kept while the file is edited would see the changes
+    // or crash when it is truncated
+    class mapped_file
+    {
+    public:
+        // throws std::runtime_error if the file cannot be read
+        explicit mapped_file(const char *path);
+
+        const char* data() const STANDARDESE_NOEXCEPT
+        {
+            return data_.get();
+        }
+
+        std::size_t size() const STANDARDESE_NOEXCEPT
+        {
+            return size_;
+        }
+
+        std::time_t get_time() const STANDARDESE_NOEXCEPT
+        {
+            return time_;
+        }
+
+        // returns a pointer to the contents that keeps them alive
+        const std::shared_ptr<const char>& share() const STANDARDESE_NOEXCEPT
+        {
+            return data_;
+        }
+
+        // returns whether the file on disk has been replaced or modified since it was read
+        bool is_modified() const STANDARDESE_NOEXCEPT;
+
+    private:
+        struct file_id
+        {
+            unsigned long long device, inode, size;
+            std::time_t time;
+            long time_nsec;
+
+            bool operator==(const file_id &other) const STANDARDESE_NOEXCEPT;
+        };
+
+        std::shared_ptr<const char> data_;
+        std::size_t size_;
+        std::time_t time_;
+        std::string path_;
+        file_id id_;
+    };
+}} // namespace standardese::detail
+
+#endif // STANDARDESE_DETAIL_MAPPED_FILE_HPP_INCLUDED
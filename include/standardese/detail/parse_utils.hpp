@@ -7,6 +7,7 @@
 
 #include <string>
 
+#include <standardese/detail/declaration.hpp>
 #include <standardese/cpp_cursor.hpp>
 #include <standardese/cpp_entity.hpp>
 #include <standardese/cpp_function.hpp>
@@ -35,36 +36,35 @@ namespace standardese
         cpp_name parse_scope(cpp_cursor cur);
 
         // parses the name of a typedef type
-        cpp_name parse_typedef_type_name(cpp_cursor cur, const cpp_name &name);
+        cpp_name parse_typedef_type_name(const declaration &decl);
 
         // parses the name of a variable type
         // also provides initializer
-        cpp_name parse_variable_type_name(cpp_cursor cur, const cpp_name &name, std::string &initializer);
+        cpp_name parse_variable_type_name(const declaration &decl, std::string &initializer);
 
         // parses the name of a C++ alias
-        cpp_name parse_alias_type_name(cpp_cursor cur);
+        cpp_name parse_alias_type_name(const declaration &decl);
 
         // parses the name of the underlying type of an enum
-        cpp_name parse_enum_type_name(cpp_cursor cur, bool &definition);
+        cpp_name parse_enum_type_name(const declaration &decl, bool &definition);
 
         // parses function information
         // returns the name of the return type
-        cpp_name parse_function_info(cpp_cursor cur, const cpp_name &name,
+        cpp_name parse_function_info(cpp_cursor cur, const declaration &decl,
                                      cpp_function_info &finfo,
                                      cpp_member_function_info &minfo);
 
         // parses the default type of a C++ template type parameter
-        cpp_name parse_template_type_default(cpp_cursor cur, bool &variadic);
+        cpp_name parse_template_type_default(const declaration &decl, bool &variadic);
 
         // parses type and name of a C++ non type template parameter
-        cpp_name parse_template_non_type_type(cpp_cursor cur, const cpp_name &name,
-                                              std::string &def, bool &variadic);
+        cpp_name parse_template_non_type_type(const declaration &decl, std::string &def, bool &variadic);
 
         // parses name of a template specialization
-        cpp_name parse_template_specialization_name(cpp_cursor cur, const cpp_name &name);
+        cpp_name parse_template_specialization_name(const declaration &decl);
 
         // parses the replacement of a macro
-        std::string parse_macro_replacement(cpp_cursor cur, const cpp_name &name, std::string &args);
+        std::string parse_macro_replacement(const declaration &decl, std::string &args);
 
         // wrapper for clang_visitChildren
         template <typename Fnc>
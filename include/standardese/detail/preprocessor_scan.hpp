@@ -0,0 +1,35 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_DETAIL_PREPROCESSOR_SCAN_HPP_INCLUDED
+#define STANDARDESE_DETAIL_PREPROCESSOR_SCAN_HPP_INCLUDED
+
+#include <clang-c/Index.h>
+#include <vector>
+
+#include <standardese/cpp_entity.hpp>
+
+namespace standardese { namespace detail
+{
+    class mapped_file;
+
+    // an inclusion directive or macro definition found by scan_preprocessor()
+    struct preprocessor_entity
+    {
+        unsigned offset; // of the '#' in the file
+        cpp_entity_ptr entity;
+
+        preprocessor_entity(unsigned offset, cpp_entity_ptr e)
+        : offset(offset), entity(std::move(e)) {}
+    };
+
+    // lexes the file once and returns all inclusion directives and macro definitions
+    // in the order they appear, this doesn't need the detailed preprocessing record
+    // conditional compilation is not evaluated, all branches are scanned
+    // they don't have comments
+    std::vector<preprocessor_entity> scan_preprocessor(CXTranslationUnit tu, CXFile file,
+                                                       const mapped_file &source);
+}} // namespace standardese::detail
+
+#endif // STANDARDESE_DETAIL_PREPROCESSOR_SCAN_HPP_INCLUDED
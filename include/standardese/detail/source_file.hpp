@@ -0,0 +1,44 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_DETAIL_SOURCE_FILE_HPP_INCLUDED
+#define STANDARDESE_DETAIL_SOURCE_FILE_HPP_INCLUDED
+
+#include <clang-c/Index.h>
+#include <memory>
+
+#include <standardese/detail/mapped_file.hpp>
+
+namespace standardese { namespace detail
+{
+    // returns the contents of a file parsed by libclang
+    // or nullptr if they aren't available or the file was modified after parsing
+    std::shared_ptr<const mapped_file> get_source_file(CXFile file);
+
+    // returns the offset of loc in file
+    // or false if it is in a different file
+    bool get_source_offset(CXSourceLocation loc, CXFile file, unsigned &offset) STANDARDESE_NOEXCEPT;
+
+    // makes the already read contents of a file available to get_source_file()
+    // for the current thread while it is alive
+    class source_file_scope
+    {
+    public:
+        source_file_scope(CXFile file, std::shared_ptr<const mapped_file> source) STANDARDESE_NOEXCEPT;
+
+        source_file_scope(const source_file_scope&) = delete;
+        source_file_scope& operator=(const source_file_scope&) = delete;
+
+        ~source_file_scope() STANDARDESE_NOEXCEPT;
+
+    private:
+        CXFile file_;
+        std::shared_ptr<const mapped_file> source_;
+        source_file_scope *prev_;
+
+        friend std::shared_ptr<const mapped_file> get_source_file(CXFile file);
+    };
+}} // namespace standardese::detail
+
+#endif // STANDARDESE_DETAIL_SOURCE_FILE_HPP_INCLUDED
@@ -0,0 +1,247 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_DETAIL_TOKENIZER_HPP_INCLUDED
+#define STANDARDESE_DETAIL_TOKENIZER_HPP_INCLUDED
+
+#include <clang-c/Index.h>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <standardese/noexcept.hpp>
+
+namespace standardese { namespace detail
+{
+    // the keywords the parsing functions look for
+    // also includes the contextual keywords final and override and the directives define and include
+    enum token_keyword
+    {
+        no_keyword,
+        keyword_auto,
+        keyword_class,
+        keyword_const,
+        keyword_constexpr,
+        keyword_decltype,
+        keyword_default,
+        keyword_define,
+        keyword_delete,
+        keyword_explicit,
+        keyword_extern,
+        keyword_final,
+        keyword_include,
+        keyword_inline,
+        keyword_mutable,
+        keyword_noexcept,
+        keyword_operator,
+        keyword_override,
+        keyword_static,
+        keyword_template,
+        keyword_thread_local,
+        keyword_typedef,
+        keyword_typename,
+        keyword_virtual,
+        keyword_volatile
+    };
+
+    // returns the keyword with the given spelling or no_keyword
+    token_keyword get_keyword(const char *spelling, std::size_t length) STANDARDESE_NOEXCEPT;
+
+    // the punctuators the parsing functions look for
+    enum token_punctuation
+    {
+        no_punctuation,
+        punctuation_paren_open,
+        punctuation_paren_close,
+        punctuation_bracket_open,
+        punctuation_bracket_close,
+        punctuation_brace_open,
+        punctuation_brace_close,
+        punctuation_angle_open,
+        punctuation_angle_close,
+        punctuation_shift_right, // >>, closes two template argument lists
+        punctuation_colon,
+        punctuation_semicolon,
+        punctuation_equal,
+        punctuation_arrow,
+        punctuation_ellipsis,
+        punctuation_amp,
+        punctuation_amp_amp
+    };
+
+    // returns the punctuator with the given spelling or no_punctuation
+    token_punctuation get_punctuation(const char *spelling, std::size_t length) STANDARDESE_NOEXCEPT;
+
+    class tokenizer;
+
+    // a token of a cursor
+    // the spelling is not null-terminated
+    class token
+    {
+    public:
+        const char* data() const STANDARDESE_NOEXCEPT
+        {
+            return spelling_;
+        }
+
+        std::size_t size() const STANDARDESE_NOEXCEPT
+        {
+            return length_;
+        }
+
+        std::string str() const
+        {
+            return std::string(spelling_, length_);
+        }
+
+        CXTokenKind get_kind() const STANDARDESE_NOEXCEPT
+        {
+            return kind_;
+        }
+
+        token_keyword get_keyword() const STANDARDESE_NOEXCEPT
+        {
+            return keyword_;
+        }
+
+        token_punctuation get_punctuation() const STANDARDESE_NOEXCEPT
+        {
+            return punctuation_;
+        }
+
+        // the number of enclosing (), [] and {}
+        // a bracket itself has the depth of its surroundings
+        unsigned get_depth() const STANDARDESE_NOEXCEPT
+        {
+            return depth_;
+        }
+
+    private:
+        token(const char *spelling, std::size_t length, CXTokenKind kind,
+              token_keyword keyword, token_punctuation punctuation) STANDARDESE_NOEXCEPT
+        : spelling_(spelling), length_(length), kind_(kind),
+          keyword_(keyword), punctuation_(punctuation), depth_(0u) {}
+
+        const char *spelling_;
+        std::size_t length_;
+        CXTokenKind kind_;
+        token_keyword keyword_;
+        token_punctuation punctuation_;
+        unsigned depth_;
+
+        friend tokenizer;
+    };
+
+    inline bool operator==(const token &a, token_keyword b) STANDARDESE_NOEXCEPT
+    {
+        return a.get_keyword() == b;
+    }
+
+    inline bool operator==(token_keyword a, const token &b) STANDARDESE_NOEXCEPT
+    {
+        return a == b.get_keyword();
+    }
+
+    inline bool operator!=(const token &a, token_keyword b) STANDARDESE_NOEXCEPT
+    {
+        return !(a == b);
+    }
+
+    inline bool operator!=(token_keyword a, const token &b) STANDARDESE_NOEXCEPT
+    {
+        return !(a == b);
+    }
+
+    inline bool operator==(const token &a, token_punctuation b) STANDARDESE_NOEXCEPT
+    {
+        return a.get_punctuation() == b;
+    }
+
+    inline bool operator==(token_punctuation a, const token &b) STANDARDESE_NOEXCEPT
+    {
+        return a == b.get_punctuation();
+    }
+
+    inline bool operator!=(const token &a, token_punctuation b) STANDARDESE_NOEXCEPT
+    {
+        return !(a == b);
+    }
+
+    inline bool operator!=(token_punctuation a, const token &b) STANDARDESE_NOEXCEPT
+    {
+        return !(a == b);
+    }
+
+    inline bool operator==(const token &a, const char *b) STANDARDESE_NOEXCEPT
+    {
+        return std::strncmp(a.data(), b, a.size()) == 0 && b[a.size()] == '\0';
+    }
+
+    inline bool operator==(const char *a, const token &b) STANDARDESE_NOEXCEPT
+    {
+        return b == a;
+    }
+
+    inline bool operator!=(const token &a, const char *b) STANDARDESE_NOEXCEPT
+    {
+        return !(a == b);
+    }
+
+    inline bool operator!=(const char *a, const token &b) STANDARDESE_NOEXCEPT
+    {
+        return !(a == b);
+    }
+
+    // tokenizes a cursor once and classifies each token
+    // it is passed to all parsing functions of that cursor
+    // the spellings point directly into the source file read by the parser
+    class tokenizer
+    {
+    public:
+        using iterator = std::vector<token>::const_iterator;
+
+        explicit tokenizer(CXCursor cur);
+
+        // uses the already lexed tokens [begin, end)
+        tokenizer(CXTranslationUnit tu, CXToken *begin, CXToken *end);
+
+        tokenizer(const tokenizer&) = delete;
+        tokenizer& operator=(const tokenizer&) = delete;
+
+        iterator begin() const STANDARDESE_NOEXCEPT
+        {
+            return tokens_.begin();
+        }
+
+        iterator end() const STANDARDESE_NOEXCEPT
+        {
+            return tokens_.end();
+        }
+
+        std::size_t size() const STANDARDESE_NOEXCEPT
+        {
+            return tokens_.size();
+        }
+
+    private:
+        void init(CXTranslationUnit tu, CXToken *tokens, unsigned no_tokens);
+
+        std::vector<token> tokens_;
+        std::shared_ptr<const char> source_;
+        std::string spellings_;
+    };
+
+    // calls fn for each token
+    // aborts when returned false
+    template <typename Fnc>
+    void visit_tokens(const tokenizer &tokens, Fnc fn)
+    {
+        for (auto& t : tokens)
+            if (!fn(t))
+                break;
+    }
+}} // namespace standardese::detail
+
+#endif // STANDARDESE_DETAIL_TOKENIZER_HPP_INCLUDED
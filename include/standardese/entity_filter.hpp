@@ -0,0 +1,84 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_ENTITY_FILTER_HPP_INCLUDED
+#define STANDARDESE_ENTITY_FILTER_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include <standardese/cpp_class.hpp>
+#include <standardese/cpp_cursor.hpp>
+#include <standardese/cpp_entity.hpp>
+
+namespace standardese
+{
+    /// Decides which entities are parsed at all.
+    /// It runs before an entity is parsed,
+    /// an excluded entity is skipped together with all of its children.
+    class entity_filter
+    {
+    public:
+        entity_filter() STANDARDESE_NOEXCEPT
+        : types_(0u), access_(cpp_private), documented_only_(false) {}
+
+        /// Excludes all namespaces with the given name (e.g. "detail"),
+        /// or the given name including all scopes (e.g. "foo::impl").
+        void blacklist_namespace(std::string name)
+        {
+            namespaces_.push_back(std::move(name));
+        }
+
+        /// Excludes all entities of the given type.
+        /// Any of the enum value types excludes all enum values.
+        void blacklist_type(cpp_entity::type t) STANDARDESE_NOEXCEPT
+        {
+            types_ |= 1ull << t;
+        }
+
+        bool is_blacklisted(cpp_entity::type t) const STANDARDESE_NOEXCEPT
+        {
+            return (types_ & (1ull << t)) != 0u;
+        }
+
+        /// Excludes class members with a lower access than the given one,
+        /// unless they have a comment.
+        /// Access specifiers and base classes are kept, they are part of the class synopsis.
+        void set_minimum_access(cpp_access_specifier_t access) STANDARDESE_NOEXCEPT
+        {
+            access_ = access;
+        }
+
+        cpp_access_specifier_t get_minimum_access() const STANDARDESE_NOEXCEPT
+        {
+            return access_;
+        }
+
+        /// Sets whether entities in a namespace without a comment are excluded.
+        /// Members of classes and enums aren't affected,
+        /// they are still part of the synopsis of their parent.
+        void set_documented_only(bool documented_only) STANDARDESE_NOEXCEPT
+        {
+            documented_only_ = documented_only;
+        }
+
+        bool is_documented_only() const STANDARDESE_NOEXCEPT
+        {
+            return documented_only_;
+        }
+
+        /// Returns whether the entity cur refers to is excluded.
+        bool is_excluded(cpp_cursor cur) const;
+
+    private:
+        static_assert(cpp_entity::access_specifier_t < 64, "too many entity types for the mask");
+
+        std::vector<std::string> namespaces_;
+        unsigned long long types_;
+        cpp_access_specifier_t access_;
+        bool documented_only_;
+    };
+} // namespace standardese
+
+#endif // STANDARDESE_ENTITY_FILTER_HPP_INCLUDED
@@ -5,16 +5,30 @@
 #ifndef STANDARDESE_GENERATOR_HPP_INCLUDED
 #define STANDARDESE_GENERATOR_HPP_INCLUDED
 
+#include <cstdint>
+
 #include <standardese/output.hpp>
 #include <standardese/translation_unit.hpp>
 
 namespace standardese
 {
+    class ast_snapshot;
+
     const char* get_entity_type_spelling(cpp_entity::type t);
 
     void generate_doc_entity(output_base &output, unsigned level, const cpp_entity &e);
 
+    /// Generates the documentation of an entity of a snapshot and its documented members,
+    /// like it is generated as part of the file.
+    void generate_doc_entity(output_base &output, unsigned level,
+                             const ast_snapshot &snapshot, std::uint32_t i);
+
     void generate_doc_file(output_base &output, const cpp_file &f);
+
+    /// Generates the documentation of a file from its snapshot,
+    /// the snapshot can be reused for multiple outputs.
+    /// Only the data stored in the snapshot is used, so it also works for a loaded one.
+    void generate_doc_file(output_base &output, const ast_snapshot &snapshot);
 } // namespace standardese
 
 #endif // STANDARDESE_GENERATOR_HPP_INCLUDED
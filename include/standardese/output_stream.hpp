@@ -8,6 +8,7 @@
 #include <cassert>
 #include <fstream>
 #include <ostream>
+#include <string>
 
 #include <standardese/noexcept.hpp>
 
@@ -97,6 +98,34 @@ namespace standardese
 
         std::ofstream file_;
     };
+
+    /// Writes to a file, but only if its contents change.
+    /// The output is kept in memory and compared with the existing file on close(),
+    /// an unchanged file isn't touched at all.
+    class file_update_output
+    : public output_stream_base
+    {
+    public:
+        explicit file_update_output(std::string file)
+        : file_(std::move(file)), closed_(false) {}
+
+        /// Calls close() if it hasn't been called, errors are ignored.
+        ~file_update_output() STANDARDESE_NOEXCEPT override;
+
+        /// Writes the file if the contents differ from the existing one.
+        /// Returns whether it was written.
+        /// Throws std::runtime_error if it cannot be written.
+        bool close();
+
+    private:
+        void do_write_char(char c) override
+        {
+            buffer_.push_back(c);
+        }
+
+        std::string file_, buffer_;
+        bool closed_;
+    };
 } // namespace standardese
 
 #endif // STANDARDESE_OUTPUT_STREAM_HPP_INCLUDED
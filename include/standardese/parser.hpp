@@ -7,10 +7,14 @@
 
 #include <clang-c/Index.h>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <standardese/detail/wrapper.hpp>
 #include <standardese/cpp_entity.hpp>
+#include <standardese/entity_filter.hpp>
+#include <standardese/shared_string.hpp>
 
 namespace standardese
 {
@@ -29,6 +33,20 @@ namespace standardese
         static const char* const cpp_14;
     };
 
+    /// How inclusion directives and macro definitions are parsed.
+    enum preprocessor_mode
+    {
+        /// They are not parsed at all.
+        preprocessor_none,
+        /// Only the main file is scanned for them after parsing.
+        /// This doesn't need the detailed preprocessing record of libclang,
+        /// but conditional compilation isn't evaluated and they don't have comments.
+        preprocessor_scan,
+        /// libclang records them in a detailed preprocessing record,
+        /// this is the default.
+        preprocessor_detailed
+    };
+
     /// Parser class used for parsing the C++ classes.
     /// The parser object must live as long as all the translation units.
     class parser
@@ -46,8 +64,85 @@ namespace standardese
 
         /// Parses a translation unit.
         /// standard must be one of the cpp_standard values.
+        /// Throws std::runtime_error if libclang fails to parse it or crashes while parsing.
         translation_unit parse(const char *path, const char *standard) const;
 
+        /// Parses multiple files in a single translation unit that includes all of them.
+        /// The includes they have in common are only parsed once,
+        /// so it is faster for related files, like all headers of a library.
+        /// Returns a translation unit for each file, in the same order,
+        /// the AST of all of them can be built using translation_unit::build_ast().
+        std::vector<translation_unit> parse(const std::vector<std::string> &paths, const char *standard) const;
+
+        /// Parses the translation unit again after its file or one of its includes has changed.
+        /// This is faster than parsing it from scratch,
+        /// translation_unit::build_ast() then builds the AST of the new version,
+        /// the AST of the previous version is destroyed and removed from the registries.
+        /// Throws std::invalid_argument if it is part of a batch
+        /// and std::runtime_error if libclang fails to parse it or crashes while parsing.
+        void reparse(translation_unit &tu) const;
+
+        /// Builds a precompiled header at path that includes all of the given headers.
+        /// They are found relative to the working directory or in the include paths,
+        /// like the include directive `#include "vector"`.
+        /// It is meant for the heavy system and third-party headers all files include.
+        /// Throws std::runtime_error if it cannot be built.
+        void build_pch(const std::vector<std::string> &headers, const char *standard, const char *path) const;
+
+        /// Sets the precompiled header included in all translation units parsed afterwards,
+        /// it must be built with the same standard.
+        /// An empty path disables it.
+        void set_pch(std::string path)
+        {
+            pch_ = std::move(path);
+        }
+
+        const std::string& get_pch() const STANDARDESE_NOEXCEPT
+        {
+            return pch_;
+        }
+
+        /// Sets how preprocessor entities are parsed,
+        /// it is used for all translation units parsed afterwards.
+        void set_preprocessor_mode(preprocessor_mode mode) STANDARDESE_NOEXCEPT
+        {
+            preprocessor_ = mode;
+        }
+
+        preprocessor_mode get_preprocessor_mode() const STANDARDESE_NOEXCEPT
+        {
+            return preprocessor_;
+        }
+
+        /// Sets whether translation units keep the includes at the beginning of the file precompiled,
+        /// so reparse() doesn't parse them again as long as they don't change.
+        /// It costs memory and is used for all translation units parsed afterwards.
+        void set_precompiled_preamble(bool value) STANDARDESE_NOEXCEPT
+        {
+            preamble_ = value;
+        }
+
+        bool has_precompiled_preamble() const STANDARDESE_NOEXCEPT
+        {
+            return preamble_;
+        }
+
+        /// Sets the filter deciding which entities are parsed,
+        /// it is used when building the AST.
+        void set_filter(entity_filter filter)
+        {
+            filter_ = std::move(filter);
+        }
+
+        const entity_filter& get_filter() const STANDARDESE_NOEXCEPT
+        {
+            return filter_;
+        }
+
+        /// Returns a shared copy of str.
+        /// Equal strings share the same storage for the lifetime of the parser.
+        shared_string intern(const std::string &str) const;
+
         void register_file(cpp_ptr<cpp_file> file) const;
 
         // void(const cpp_file &file)
@@ -140,6 +235,10 @@ namespace standardese
 
         detail::wrapper<CXIndex, deleter> index_;
         std::unique_ptr<impl> pimpl_;
+        entity_filter filter_;
+        preprocessor_mode preprocessor_;
+        bool preamble_;
+        std::string pch_;
     };
 } // namespace standardese
 
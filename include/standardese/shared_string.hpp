@@ -0,0 +1,145 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_SHARED_STRING_HPP_INCLUDED
+#define STANDARDESE_SHARED_STRING_HPP_INCLUDED
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <standardese/noexcept.hpp>
+
+namespace standardese
+{
+    /// An immutable string that shares its storage.
+    /// Copying only copies a reference to the characters,
+    /// strings interned by the parser compare equal through their address.
+    /// The characters are not necessarily null-terminated.
+    class shared_string
+    {
+    public:
+        shared_string() STANDARDESE_NOEXCEPT
+        : size_(0u) {}
+
+        shared_string(const char *str)
+        : shared_string(std::string(str)) {}
+
+        shared_string(std::string str)
+        : size_(str.size())
+        {
+            if (size_ == 0u)
+                return;
+
+            auto owner = std::make_shared<std::string>(std::move(str));
+            data_ = std::shared_ptr<const char>(owner, owner->c_str());
+        }
+
+        /// Creates a string viewing size characters starting at data.
+        /// The storage is kept alive by owner.
+        shared_string(std::shared_ptr<const void> owner, const char *data, std::size_t size) STANDARDESE_NOEXCEPT
+        : data_(owner, data), size_(size) {}
+
+        const char* data() const STANDARDESE_NOEXCEPT
+        {
+            return data_ ? data_.get() : "";
+        }
+
+        std::size_t size() const STANDARDESE_NOEXCEPT
+        {
+            return size_;
+        }
+
+        bool empty() const STANDARDESE_NOEXCEPT
+        {
+            return size_ == 0u;
+        }
+
+        char operator[](std::size_t i) const STANDARDESE_NOEXCEPT
+        {
+            return data()[i];
+        }
+
+        char front() const STANDARDESE_NOEXCEPT
+        {
+            return data()[0];
+        }
+
+        char back() const STANDARDESE_NOEXCEPT
+        {
+            return data()[size_ - 1];
+        }
+
+        const char* begin() const STANDARDESE_NOEXCEPT
+        {
+            return data();
+        }
+
+        const char* end() const STANDARDESE_NOEXCEPT
+        {
+            return data() + size_;
+        }
+
+        std::string str() const
+        {
+            return std::string(data(), size_);
+        }
+
+    private:
+        std::shared_ptr<const char> data_;
+        std::size_t size_;
+    };
+
+    inline bool operator==(const shared_string &a, const shared_string &b) STANDARDESE_NOEXCEPT
+    {
+        if (a.size() != b.size())
+            return false;
+        return a.data() == b.data() || std::memcmp(a.data(), b.data(), a.size()) == 0;
+    }
+
+    inline bool operator==(const shared_string &a, const char *b) STANDARDESE_NOEXCEPT
+    {
+        return std::strlen(b) == a.size() && std::memcmp(a.data(), b, a.size()) == 0;
+    }
+
+    inline bool operator==(const char *a, const shared_string &b) STANDARDESE_NOEXCEPT
+    {
+        return b == a;
+    }
+
+    inline bool operator==(const shared_string &a, const std::string &b) STANDARDESE_NOEXCEPT
+    {
+        return b.size() == a.size() && std::memcmp(a.data(), b.data(), a.size()) == 0;
+    }
+
+    inline bool operator==(const std::string &a, const shared_string &b) STANDARDESE_NOEXCEPT
+    {
+        return b == a;
+    }
+
+    template <typename T>
+    bool operator!=(const shared_string &a, const T &b) STANDARDESE_NOEXCEPT
+    {
+        return !(a == b);
+    }
+
+    template <typename T>
+    bool operator!=(const T &a, const shared_string &b) STANDARDESE_NOEXCEPT
+    {
+        return !(a == b);
+    }
+
+    inline bool operator!=(const shared_string &a, const shared_string &b) STANDARDESE_NOEXCEPT
+    {
+        return !(a == b);
+    }
+
+    inline bool operator<(const shared_string &a, const shared_string &b) STANDARDESE_NOEXCEPT
+    {
+        auto res = std::memcmp(a.data(), b.data(), a.size() < b.size() ? a.size() : b.size());
+        return res < 0 || (res == 0 && a.size() < b.size());
+    }
+} // namespace standardese
+
+#endif // STANDARDESE_SHARED_STRING_HPP_INCLUDED
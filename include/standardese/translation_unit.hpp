@@ -6,13 +6,21 @@
 #define STANDARDESE_TRANSLATION_UNIT_HPP_INCLUDED
 
 #include <clang-c/Index.h>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include <standardese/detail/wrapper.hpp>
 #include <standardese/cpp_entity.hpp>
 
 namespace standardese
 {
+    namespace detail
+    {
+        class mapped_file;
+    } // namespace detail
+
     class parser;
 
     class cpp_file
@@ -52,8 +60,30 @@ namespace standardese
             clang_visitChildren(clang_getTranslationUnitCursor(tu_.get()), visitor_impl, &data);
         }
 
+        /// Builds the AST of the file and registers it in the parser.
+        /// The AST doesn't need the translation unit,
+        /// so it can be destroyed right afterwards to free the libclang memory.
+        /// Only the libclang handles exposed by the entities become invalid then.
+        /// The comments refer to the contents of the file the parser has read into memory,
+        /// so they aren't copied, and editing the file doesn't affect them.
         cpp_file& build_ast() const;
 
+        /// Builds the AST of all files of a batch returned by parser::parse()
+        /// in a single pass over their shared translation unit.
+        /// Returns the files in the same order.
+        /// Throws std::invalid_argument if they don't share a translation unit.
+        static std::vector<cpp_file*> build_ast(const std::vector<translation_unit> &batch);
+
+        /// Returns the paths of all files the file includes, directly or indirectly.
+        /// For a file of a batch these are all files of the shared translation unit,
+        /// as a header included by multiple files of it is only recorded for the first one.
+        /// Files included through a precompiled header are not part of it.
+        std::vector<std::string> get_includes() const;
+
+        /// Returns the number of bytes libclang uses for the translation unit.
+        /// For a batch it is the memory of the shared translation unit.
+        std::size_t get_memory_usage() const;
+
         const char* get_path() const STANDARDESE_NOEXCEPT
         {
             return path_.c_str();
@@ -62,19 +92,28 @@ namespace standardese
         CXFile get_cxfile() const STANDARDESE_NOEXCEPT;
 
     private:
-        translation_unit(const parser &par, CXTranslationUnit tu, const char *path);
+        using tu_ptr = std::shared_ptr<std::remove_pointer<CXTranslationUnit>::type>;
+
+        translation_unit(const parser &par, tu_ptr tu, const char *path);
 
         class scope_stack;
-        CXChildVisitResult parse_visit(scope_stack &stack, CXCursor cur, CXCursor parent) const;
+        void scan_preprocessor(scope_stack &stack) const;
+        void parse_entity(scope_stack &stack, CXCursor cur, CXFile file) const;
+        void parse_children(scope_stack &stack, CXCursor parent, CXFile file) const;
+        CXChildVisitResult parse_visit(scope_stack &stack, CXCursor cur) const;
 
         struct deleter
         {
             void operator()(CXTranslationUnit tu) const STANDARDESE_NOEXCEPT;
         };
 
-        detail::wrapper<CXTranslationUnit, deleter> tu_;
+        // shared by all files parsed in one batch
+        tu_ptr tu_;
         std::string path_;
+        std::shared_ptr<const detail::mapped_file> source_;
         const parser *parser_;
+        bool scan_preprocessor_;
+        bool batch_;
 
         friend parser;
     };
@@ -0,0 +1,355 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/ast_snapshot.hpp>
+
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#include <standardese/detail/mapped_file.hpp>
+#include <standardese/cpp_class.hpp>
+#include <standardese/cpp_enum.hpp>
+#include <standardese/cpp_namespace.hpp>
+#include <standardese/cpp_template.hpp>
+#include <standardese/output_stream.hpp>
+#include <standardese/synopsis.hpp>
+#include <standardese/translation_unit.hpp>
+
+using namespace standardese;
+
+const ast_snapshot::index ast_snapshot::no_parent;
+
+namespace
+{
+    template <typename T, typename Func>
+    void for_each_member(const cpp_entity_container<T> &container, Func f)
+    {
+        for (auto& e : container)
+            f(e);
+    }
+
+    template <typename Func>
+    void for_each_child(const cpp_entity &e, Func f)
+    {
+        switch (e.get_entity_type())
+        {
+            case cpp_entity::file_t:
+                for_each_member(static_cast<const cpp_file&>(e), f);
+                break;
+            case cpp_entity::namespace_t:
+                for_each_member(static_cast<const cpp_namespace&>(e), f);
+                break;
+            case cpp_entity::class_t:
+                for_each_member(static_cast<const cpp_class&>(e), f);
+                break;
+            case cpp_entity::enum_t:
+                for_each_member(static_cast<const cpp_enum&>(e), f);
+                break;
+
+            case cpp_entity::class_template_t:
+                for_each_member(static_cast<const cpp_class_template&>(e).get_class(), f);
+                break;
+            case cpp_entity::class_template_full_specialization_t:
+                for_each_member(static_cast<const cpp_class_template_full_specialization&>(e).get_class(), f);
+                break;
+            case cpp_entity::class_template_partial_specialization_t:
+                for_each_member(static_cast<const cpp_class_template_partial_specialization&>(e).get_class(), f);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    std::size_t align(std::size_t offset, std::size_t alignment)
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    // offsets of the arrays inside the block
+    struct block_layout
+    {
+        std::size_t parents, first_child, names, scopes, comments, synopsis, kinds, pool;
+
+        template <typename Index, typename Span>
+        static block_layout get(std::size_t size)
+        {
+            block_layout result;
+            result.parents = 0u;
+            result.first_child = result.parents + size * sizeof(Index);
+            result.names = align(result.first_child + (size + 1) * sizeof(Index), alignof(Span));
+            result.scopes = result.names + size * sizeof(Span);
+            result.comments = result.scopes + size * sizeof(Span);
+            result.synopsis = result.comments + size * sizeof(Span);
+            result.kinds = result.synopsis + size * sizeof(Span);
+            result.pool = result.kinds + size * sizeof(std::uint8_t);
+            return result;
+        }
+    };
+
+    // captures the synopsis as plain text
+    class string_output
+    : public output_stream_base
+    {
+    public:
+        string_output()
+        {
+            // start at the beginning of a line like inside a code block
+            write_char('\n');
+            str_.clear();
+        }
+
+        std::string& get() STANDARDESE_NOEXCEPT
+        {
+            return str_;
+        }
+
+    private:
+        void do_write_char(char c) override
+        {
+            str_ += c;
+        }
+
+        std::string str_;
+    };
+
+    class synopsis_output
+    : public output_base
+    {
+    public:
+        synopsis_output(output_stream_base &output) STANDARDESE_NOEXCEPT
+        : output_base(output) {}
+
+    protected:
+        void write_header_begin(unsigned) override {}
+        void do_write_seperator() override {}
+        void write_begin(style) override {}
+        void write_paragraph_begin() override {}
+        void write_code_block_begin() override {}
+        void do_write_section_heading(const std::string &) override {}
+    };
+
+    std::string render_synopsis(const cpp_entity &e)
+    {
+        string_output str;
+        synopsis_output out(str);
+        write_synopsis(out, e);
+        return std::move(str.get());
+    }
+
+    const char magic[8] = {'S', 'T', 'D', 'S', 'N', 'A', 'P', '\0'};
+    const std::uint32_t format_version = 1u;
+    const std::uint32_t byte_order = 0x01020304;
+
+    // block follows, aligned to 8
+    struct file_header
+    {
+        char magic[8];
+        std::uint32_t version, byte_order;
+        std::uint64_t size, block_size;
+    };
+}
+
+ast_snapshot::ast_snapshot(const cpp_file &f)
+: ast_snapshot(static_cast<const cpp_entity&>(f)) {}
+
+ast_snapshot::ast_snapshot(const cpp_entity &root)
+{
+    // breadth-first, so the children of each entity are contiguous
+    std::vector<index> parents, first_child;
+    entities_.push_back(&root);
+    parents.push_back(no_parent);
+    for (index i = 0u; i != entities_.size(); ++i)
+    {
+        first_child.push_back(index(entities_.size()));
+        for_each_child(*entities_[i], [&](const cpp_entity &child)
+        {
+            entities_.push_back(&child);
+            parents.push_back(i);
+        });
+    }
+    auto size = entities_.size();
+    first_child.push_back(index(size));
+
+    // string pool, scopes are usually interned and thus shared
+    std::string pool;
+    auto add_string = [&](const char *str, std::size_t length)
+    {
+        span result{std::uint32_t(pool.size()), std::uint32_t(length)};
+        pool.append(str, length);
+        return result;
+    };
+
+    std::vector<span> names, scopes, comments, synopsis;
+    std::map<std::pair<const char*, std::size_t>, span> scope_spans;
+    for (auto e : entities_)
+    {
+        names.push_back(add_string(e->get_name().data(), e->get_name().size()));
+
+        auto& scope = e->get_scope();
+        auto key = std::make_pair(scope.data(), scope.size());
+        auto iter = scope_spans.find(key);
+        if (iter == scope_spans.end())
+            iter = scope_spans.emplace(key, add_string(scope.data(), scope.size())).first;
+        scopes.push_back(iter->second);
+
+        comments.push_back(add_string(e->get_comment().data(), e->get_comment().size()));
+
+        if (e->get_entity_type() == cpp_entity::file_t || !e->get_comment().empty())
+        {
+            auto str = render_synopsis(*e);
+            synopsis.push_back(add_string(str.data(), str.size()));
+        }
+        else
+            synopsis.push_back(span{0u, 0u});
+    }
+
+    auto layout = block_layout::get<index, span>(size);
+    auto block_size = layout.pool + pool.size();
+
+    std::shared_ptr<char> block(new char[block_size], std::default_delete<char[]>());
+    std::memcpy(block.get() + layout.parents, parents.data(), size * sizeof(index));
+    std::memcpy(block.get() + layout.first_child, first_child.data(), (size + 1) * sizeof(index));
+    std::memcpy(block.get() + layout.names, names.data(), size * sizeof(span));
+    std::memcpy(block.get() + layout.scopes, scopes.data(), size * sizeof(span));
+    std::memcpy(block.get() + layout.comments, comments.data(), size * sizeof(span));
+    std::memcpy(block.get() + layout.synopsis, synopsis.data(), size * sizeof(span));
+    for (std::size_t i = 0u; i != size; ++i)
+        block.get()[layout.kinds + i] = char(entities_[i]->get_entity_type());
+    std::memcpy(block.get() + layout.pool, pool.data(), pool.size());
+
+    init(std::move(block), size, block_size);
+}
+
+ast_snapshot::ast_snapshot(std::shared_ptr<const char> block, std::size_t size, std::size_t block_size)
+{
+    auto layout = block_layout::get<index, span>(size);
+    if (block_size < layout.pool)
+        throw std::runtime_error("invalid snapshot");
+
+    init(std::move(block), size, block_size);
+
+    // validate everything a generator relies on
+    auto pool_size = block_size - layout.pool;
+    auto valid_span = [&](const span &s)
+    {
+        return s.offset <= pool_size && s.length <= pool_size - s.offset;
+    };
+
+    if (size == 0u || parents_[0] != no_parent || first_child_[size] != size)
+        throw std::runtime_error("invalid snapshot");
+    for (std::size_t i = 0u; i != size; ++i)
+    {
+        if ((i != 0u && parents_[i] >= i)
+            || first_child_[i] > first_child_[i + 1] || first_child_[i] <= i
+            || kinds_[i] > cpp_entity::access_specifier_t
+            || !valid_span(names_[i]) || !valid_span(scopes_[i])
+            || !valid_span(comments_[i]) || !valid_span(synopsis_[i]))
+            throw std::runtime_error("invalid snapshot");
+    }
+}
+
+void ast_snapshot::init(std::shared_ptr<const char> block, std::size_t size, std::size_t block_size)
+{
+    auto layout = block_layout::get<index, span>(size);
+
+    data_ = std::move(block);
+    size_ = size;
+    block_size_ = block_size;
+
+    parents_ = reinterpret_cast<const index*>(data_.get() + layout.parents);
+    first_child_ = reinterpret_cast<const index*>(data_.get() + layout.first_child);
+    names_ = reinterpret_cast<const span*>(data_.get() + layout.names);
+    scopes_ = reinterpret_cast<const span*>(data_.get() + layout.scopes);
+    comments_ = reinterpret_cast<const span*>(data_.get() + layout.comments);
+    synopsis_ = reinterpret_cast<const span*>(data_.get() + layout.synopsis);
+    kinds_ = reinterpret_cast<const std::uint8_t*>(data_.get() + layout.kinds);
+    pool_ = data_.get() + layout.pool;
+}
+
+void ast_snapshot::save(std::ostream &out) const
+{
+    file_header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = format_version;
+    header.byte_order = byte_order;
+    header.size = size_;
+    header.block_size = block_size_;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(data_.get(), std::streamsize(block_size_));
+}
+
+ast_snapshot ast_snapshot::load(const char *path)
+{
+    auto error = [&](const char *msg)
+    {
+        return std::runtime_error(std::string("snapshot '") + path + "': " + msg);
+    };
+
+    std::shared_ptr<const char> file;
+    std::size_t file_size;
+    try
+    {
+        detail::mapped_file mapped(path);
+        file = mapped.share();
+        file_size = mapped.size();
+    }
+    catch (std::runtime_error&)
+    {
+        throw error("unable to read file");
+    }
+
+    file_header header;
+    if (file_size < sizeof(header))
+        throw error("invalid snapshot");
+    std::memcpy(&header, file.get(), sizeof(header));
+
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.byte_order != byte_order)
+        throw error("invalid snapshot");
+    else if (header.version != format_version)
+        throw error("unsupported format version");
+    else if (header.block_size > file_size - sizeof(header)
+             || header.size > header.block_size)
+        throw error("invalid snapshot");
+
+    try
+    {
+        std::shared_ptr<const char> block(file, file.get() + sizeof(header));
+        return ast_snapshot(std::move(block), std::size_t(header.size), std::size_t(header.block_size));
+    }
+    catch (std::runtime_error &)
+    {
+        throw error("invalid snapshot");
+    }
+}
+
+const cpp_entity* standardese::find_entity(const cpp_file &f, const std::string &full_name)
+{
+    // whether full_name is scope::name, without concatenating them
+    auto matches = [&](const cpp_entity &e)
+    {
+        auto& scope = e.get_scope();
+        auto& name = e.get_name();
+        if (scope.empty())
+            return full_name == name;
+
+        return full_name.size() == scope.size() + 2u + name.size()
+            && full_name.compare(0u, scope.size(), scope.data(), scope.size()) == 0
+            && full_name.compare(scope.size(), 2u, "::") == 0
+            && full_name.compare(scope.size() + 2u, name.size(), name) == 0;
+    };
+
+    // breadth-first like the snapshot
+    std::vector<const cpp_entity*> entities(1u, &f);
+    for (std::size_t i = 0u; i != entities.size(); ++i)
+    {
+        if (matches(*entities[i]))
+            return entities[i];
+        for_each_child(*entities[i], [&](const cpp_entity &child) {entities.push_back(&child);});
+    }
+    return nullptr;
+}
@@ -4,10 +4,10 @@
 
 #include <standardese/cpp_class.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 #include <standardese/detail/parse_utils.hpp>
-#include <standardese/detail/search_token.hpp>
 #include <standardese/parser.hpp>
 
 using namespace standardese;
@@ -53,7 +53,7 @@ cpp_ptr<cpp_access_specifier> cpp_access_specifier::parse(cpp_cursor cur)
     return detail::make_ptr<cpp_access_specifier>(parse_access_specifier(clang_getCXXAccessSpecifier(cur)));
 }
 
-cpp_ptr<cpp_base_class> cpp_base_class::parse(cpp_name scope, cpp_cursor cur)
+cpp_ptr<cpp_base_class> cpp_base_class::parse(shared_string scope, cpp_cursor cur)
 {
     assert(clang_getCursorKind(cur) == CXCursor_CXXBaseSpecifier);
 
@@ -67,38 +67,20 @@ cpp_ptr<cpp_base_class> cpp_base_class::parse(cpp_name scope, cpp_cursor cur)
 
 namespace
 {
-    bool parse_class(cpp_cursor cur, const cpp_name &name, bool &is_final)
+    bool parse_class(const detail::declaration &decl, bool &is_final)
     {
-        auto result = false;
-        auto found = false;
-        detail::visit_tokens(cur, [&](CXToken, const string &spelling)
-        {
-            if (found)
-            {
-                if (spelling == "final")
-                    is_final = true;
-                else if (spelling == ":" || spelling == "{")
-                {
-                    result = true;
-                    return false; // class body
-                }
-                else if (spelling == ";")
-                {
-                    result = false;
-                    return false; // forward declaration
-                }
-            }
-            else if (spelling == name.c_str())
-                found = true;
-
-            return true;
-        });
-
-        return result;
+        is_final = decl.has_suffix(detail::keyword_final);
+
+        // class body or forward declaration
+        auto body = std::min(decl.find(detail::punctuation_colon), decl.find(detail::punctuation_brace_open));
+        return body < decl.find(detail::punctuation_semicolon);
     }
 }
 
-cpp_class::parser::parser(cpp_name scope, cpp_cursor cur)
+cpp_class::parser::parser(shared_string scope, cpp_cursor cur)
+: parser(std::move(scope), cur, detail::declaration(detail::tokenizer(cur), detail::parse_name(cur))) {}
+
+cpp_class::parser::parser(shared_string scope, cpp_cursor cur, const detail::declaration &decl)
 {
     cpp_class_type ctype;
 
@@ -116,11 +98,10 @@ cpp_class::parser::parser(cpp_name scope, cpp_cursor cur)
     else
         assert(false);
 
-    auto name = detail::parse_name(cur);
     bool is_final;
-    auto definition = parse_class(cur, name, is_final);
+    auto definition = parse_class(decl, is_final);
     if (definition)
-        class_ = cpp_ptr<cpp_class>(new cpp_class(std::move(scope), std::move(name), detail::parse_comment(cur),
+        class_ = cpp_ptr<cpp_class>(new cpp_class(std::move(scope), decl.get_name(), detail::parse_comment(cur),
                                     clang_getCursorType(cur), ctype, is_final));
 }
 
@@ -7,19 +7,18 @@
 #include <cassert>
 
 #include <standardese/detail/parse_utils.hpp>
-#include <standardese/detail/search_token.hpp>
 #include <standardese/parser.hpp>
 
 using namespace standardese;
 
 namespace
 {
-    cpp_type_ref parse_enum_underlying(cpp_cursor cur, const cpp_name &name, bool &definition)
+    cpp_type_ref parse_enum_underlying(cpp_cursor cur, const detail::declaration &decl, bool &definition)
     {
         assert(clang_getCursorKind(cur) == CXCursor_EnumDecl);
 
         auto type = clang_getEnumDeclIntegerType(cur);
-        auto str = detail::parse_enum_type_name(cur, definition);
+        auto str = detail::parse_enum_type_name(decl, definition);
 
         return {type, str};
     }
@@ -50,13 +49,15 @@ namespace
                || kind == CXType_Int128;
     }
 
-    bool is_explicit_value(cpp_cursor cur)
+    bool is_explicit_value(cpp_cursor cur, const cpp_name &name)
     {
-        return detail::has_token(cur, "=");
+        detail::tokenizer tokens(cur);
+        detail::declaration decl(tokens, name);
+        return decl.find(detail::punctuation_equal) != decl.get_tokens().end();
     }
 }
 
-cpp_ptr<cpp_enum_value> cpp_enum_value::parse(cpp_name scope, cpp_cursor cur)
+cpp_ptr<cpp_enum_value> cpp_enum_value::parse(shared_string scope, cpp_cursor cur)
 {
     assert(clang_getCursorKind(cur) == CXCursor_EnumConstantDecl);
 
@@ -80,34 +81,37 @@ cpp_ptr<cpp_enum_value> cpp_enum_value::parse(cpp_name scope, cpp_cursor cur)
     else
         assert(false);
 
-    result->explicit_ = is_explicit_value(cur);
+    result->explicit_ = is_explicit_value(cur, result->get_name());
 
     return result;
 }
 
 namespace
 {
-    bool is_enum_scoped(cpp_cursor cur, const cpp_name &n)
+    bool is_enum_scoped(const detail::declaration &decl)
     {
-        return detail::has_prefix_token(cur, "class", n.c_str());
+        return decl.has_prefix(detail::keyword_class);
     }
 }
 
-cpp_enum::parser::parser(cpp_name scope, cpp_cursor cur)
+cpp_enum::parser::parser(shared_string scope, cpp_cursor cur)
 {
     assert(clang_getCursorKind(cur) == CXCursor_EnumDecl);
 
     auto name = detail::parse_name(cur);
     auto type = clang_getCursorType(cur);
 
+    detail::tokenizer tokens(cur);
+    detail::declaration decl(tokens, name);
+
     bool definition;
-    auto underlying = parse_enum_underlying(cur, name, definition);
+    auto underlying = parse_enum_underlying(cur, decl, definition);
     if (definition)
     {
         enum_ = cpp_ptr<cpp_enum>(new cpp_enum(std::move(scope), std::move(name), detail::parse_comment(cur),
                                                type, std::move(underlying)));
 
-        if (is_enum_scoped(cur, enum_->get_name()))
+        if (is_enum_scoped(decl))
             enum_->is_scoped_ = true;
     }
 }
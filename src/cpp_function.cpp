@@ -19,7 +19,8 @@ namespace
         assert(clang_getCursorKind(cur) == CXCursor_ParmDecl);
 
         auto type = clang_getCursorType(cur);
-        auto type_name = detail::parse_variable_type_name(cur, name, default_value);
+        detail::tokenizer tokens(cur);
+        auto type_name = detail::parse_variable_type_name(detail::declaration(tokens, name), default_value);
 
         return {type, std::move(type_name)};
     }
@@ -37,7 +38,44 @@ cpp_ptr<cpp_function_parameter> cpp_function_parameter::parse(cpp_cursor cur)
                                                     std::move(type), std::move(default_value));
 }
 
-cpp_ptr<cpp_function_base> cpp_function_base::try_parse(cpp_name scope, cpp_cursor cur)
+namespace
+{
+    cpp_ptr<cpp_function> parse_function(shared_string scope, cpp_cursor cur,
+                                         const detail::declaration &decl);
+    cpp_ptr<cpp_member_function> parse_member_function(shared_string scope, cpp_cursor cur,
+                                                       const detail::declaration &decl);
+    cpp_ptr<cpp_conversion_op> parse_conversion_op(shared_string scope, cpp_cursor cur,
+                                                   const detail::declaration &decl);
+    cpp_ptr<cpp_constructor> parse_constructor(shared_string scope, cpp_cursor cur,
+                                               const detail::declaration &decl);
+    cpp_ptr<cpp_destructor> parse_destructor(shared_string scope, cpp_cursor cur,
+                                             const detail::declaration &decl);
+}
+
+namespace
+{
+    cpp_name parse_function_name(cpp_cursor cur)
+    {
+        if (clang_getCursorKind(cur) == CXCursor_FunctionTemplate
+            && clang_getTemplateCursorKind(cur) == CXCursor_ConversionFunction)
+            // parsing
+            // template <typename T> operator T();
+            // yields a name of
+            // operator type-parameter-0-0
+            // so workaround by calculating name from the type spelling
+            return "operator " + detail::parse_name(clang_getCursorResultType(cur));
+        return detail::parse_name(cur);
+    }
+}
+
+cpp_ptr<cpp_function_base> cpp_function_base::try_parse(shared_string scope, cpp_cursor cur)
+{
+    detail::tokenizer tokens(cur);
+    return try_parse(std::move(scope), cur, detail::declaration(tokens, parse_function_name(cur)));
+}
+
+cpp_ptr<cpp_function_base> cpp_function_base::try_parse(shared_string scope, cpp_cursor cur,
+                                                        const detail::declaration &decl)
 {
     auto kind = clang_getCursorKind(cur);
     if (kind == CXCursor_FunctionTemplate)
@@ -46,15 +84,15 @@ cpp_ptr<cpp_function_base> cpp_function_base::try_parse(cpp_name scope, cpp_curs
     switch (kind)
     {
         case CXCursor_FunctionDecl:
-            return cpp_function::parse(std::move(scope), cur);
+            return parse_function(std::move(scope), cur, decl);
         case CXCursor_CXXMethod:
-            return cpp_member_function::parse(std::move(scope), cur);
+            return parse_member_function(std::move(scope), cur, decl);
         case CXCursor_ConversionFunction:
-            return cpp_conversion_op::parse(std::move(scope), cur);
+            return parse_conversion_op(std::move(scope), cur, decl);
         case CXCursor_Constructor:
-            return cpp_constructor::parse(std::move(scope), cur);
+            return parse_constructor(std::move(scope), cur, decl);
         case CXCursor_Destructor:
-            return cpp_destructor::parse(std::move(scope), cur);
+            return parse_destructor(std::move(scope), cur, decl);
         default:
             break;
     }
@@ -64,13 +102,13 @@ cpp_ptr<cpp_function_base> cpp_function_base::try_parse(cpp_name scope, cpp_curs
 
 namespace
 {
-    cpp_type_ref parse_function_info(cpp_cursor cur, const cpp_name &name,
+    cpp_type_ref parse_function_info(cpp_cursor cur, const detail::declaration &decl,
                                      cpp_function_info &info)
     {
         auto type = clang_getCursorResultType(cur);
 
         cpp_member_function_info minfo;
-        auto type_name = detail::parse_function_info(cur, name, info, minfo);
+        auto type_name = detail::parse_function_info(cur, decl, info, minfo);
         assert(minfo.virtual_flag  == cpp_virtual_none);
         assert(minfo.cv_qualifier  == cpp_cv(0));
         assert(minfo.ref_qualifier == cpp_ref_none);
@@ -106,31 +144,41 @@ namespace
     }
 }
 
-cpp_ptr<cpp_function> cpp_function::parse(cpp_name scope, cpp_cursor cur)
+namespace
 {
-    assert(clang_getCursorKind(cur) == CXCursor_FunctionDecl
-          || clang_getTemplateCursorKind(cur) == CXCursor_FunctionDecl);
+    cpp_ptr<cpp_function> parse_function(shared_string scope, cpp_cursor cur,
+                                         const detail::declaration &decl)
+    {
+        assert(clang_getCursorKind(cur) == CXCursor_FunctionDecl
+              || clang_getTemplateCursorKind(cur) == CXCursor_FunctionDecl);
 
-    auto name = detail::parse_name(cur);
-    cpp_function_info info;
-    auto return_type = parse_function_info(cur, name, info);
+        auto name = decl.get_name();
+        cpp_function_info info;
+        auto return_type = parse_function_info(cur, decl, info);
 
-    auto result = detail::make_ptr<cpp_function>(std::move(scope), std::move(name), detail::parse_comment(cur),
-                                                 std::move(return_type), std::move(info));
+        auto result = detail::make_ptr<cpp_function>(std::move(scope), std::move(name), detail::parse_comment(cur),
+                                                     std::move(return_type), std::move(info));
 
-    parse_parameters(result.get(), cur);
+        parse_parameters(result.get(), cur);
 
-    return result;
+        return result;
+    }
+}
+
+cpp_ptr<cpp_function> cpp_function::parse(shared_string scope, cpp_cursor cur)
+{
+    detail::tokenizer tokens(cur);
+    return parse_function(std::move(scope), cur, detail::declaration(tokens, parse_function_name(cur)));
 }
 
 namespace
 {
-    cpp_type_ref parse_member_function_info(cpp_cursor cur, const cpp_name &name,
+    cpp_type_ref parse_member_function_info(cpp_cursor cur, const detail::declaration &decl,
                                             cpp_function_info &finfo,
                                             cpp_member_function_info &minfo)
     {
         auto type = clang_getCursorResultType(cur);
-        auto type_name = detail::parse_function_info(cur, name, finfo, minfo);
+        auto type_name = detail::parse_function_info(cur, decl, finfo, minfo);
 
         // no noexcept
         if (finfo.noexcept_expression.empty())
@@ -147,107 +195,128 @@ namespace
     }
 }
 
-cpp_ptr<cpp_member_function> cpp_member_function::parse(cpp_name scope, cpp_cursor cur)
+namespace
 {
-    assert(clang_getCursorKind(cur) == CXCursor_CXXMethod
-           || clang_getTemplateCursorKind(cur) == CXCursor_CXXMethod);
+    cpp_ptr<cpp_member_function> parse_member_function(shared_string scope, cpp_cursor cur,
+                                                       const detail::declaration &decl)
+    {
+        assert(clang_getCursorKind(cur) == CXCursor_CXXMethod
+               || clang_getTemplateCursorKind(cur) == CXCursor_CXXMethod);
 
-    auto name = detail::parse_name(cur);
-    cpp_function_info finfo;
-    cpp_member_function_info minfo;
-    auto return_type = parse_member_function_info(cur, name, finfo, minfo);
+        auto name = decl.get_name();
+        cpp_function_info finfo;
+        cpp_member_function_info minfo;
+        auto return_type = parse_member_function_info(cur, decl, finfo, minfo);
 
-    auto result = detail::make_ptr<cpp_member_function>(std::move(scope), std::move(name), detail::parse_comment(cur),
-                                                        std::move(return_type),
-                                                        std::move(finfo), std::move(minfo));
+        auto result = detail::make_ptr<cpp_member_function>(std::move(scope), std::move(name), detail::parse_comment(cur),
+                                                            std::move(return_type),
+                                                            std::move(finfo), std::move(minfo));
 
-    parse_parameters(result.get(), cur);
+        parse_parameters(result.get(), cur);
 
-    return result;
+        return result;
+    }
 }
 
-cpp_ptr<cpp_conversion_op> cpp_conversion_op::parse(cpp_name scope, cpp_cursor cur)
+cpp_ptr<cpp_member_function> cpp_member_function::parse(shared_string scope, cpp_cursor cur)
 {
-    assert(clang_getCursorKind(cur) == CXCursor_ConversionFunction
-           || clang_getTemplateCursorKind(cur) == CXCursor_ConversionFunction);
+    detail::tokenizer tokens(cur);
+    return parse_member_function(std::move(scope), cur, detail::declaration(tokens, parse_function_name(cur)));
+}
 
-    cpp_name name;
-    cpp_type_ref type;
-    if (clang_getCursorKind(cur) == CXCursor_ConversionFunction)
+namespace
+{
+    cpp_ptr<cpp_conversion_op> parse_conversion_op(shared_string scope, cpp_cursor cur,
+                                                   const detail::declaration &decl)
     {
-        // parse name
-        name = detail::parse_name(cur);
+        assert(clang_getCursorKind(cur) == CXCursor_ConversionFunction
+               || clang_getTemplateCursorKind(cur) == CXCursor_ConversionFunction);
+
+        auto name = decl.get_name();
 
         auto target_type = clang_getCursorResultType(cur);
         auto target_type_spelling = name.substr(9); // take everything from type after "operator "
         assert(target_type_spelling.front() != ' '); // no multiple whitespace
 
-        type = cpp_type_ref(target_type, std::move(target_type_spelling));
-    }
-    else if (clang_getCursorKind(cur) == CXCursor_FunctionTemplate)
-    {
-        // parsing
-        // template <typename T> operator T();
-        // yields a name of
-        // operator type-parameter-0-0
-        // so workaround by calculating name from the type spelling
-        auto target_type = clang_getCursorResultType(cur);
-        auto spelling = detail::parse_name(target_type);
-        name = "operator " + spelling;
+        cpp_type_ref type(target_type, std::move(target_type_spelling));
 
-        type = cpp_type_ref(target_type, spelling);
-    }
+        cpp_function_info finfo;
+        cpp_member_function_info minfo;
+        auto return_type = detail::parse_function_info(cur, decl, finfo, minfo);
+        assert(return_type.empty());
+        // no noexcept
+        if (finfo.noexcept_expression.empty())
+            finfo.noexcept_expression = "false";
 
-    cpp_function_info finfo;
-    cpp_member_function_info minfo;
-    auto return_type = detail::parse_function_info(cur, name, finfo, minfo);
-    assert(return_type.empty());
-    // no noexcept
-    if (finfo.noexcept_expression.empty())
-        finfo.noexcept_expression = "false";
+        return detail::make_ptr<cpp_conversion_op>(std::move(scope), std::move(name), detail::parse_comment(cur),
+                                                   type, std::move(finfo), std::move(minfo));
+    }
+}
 
-    return detail::make_ptr<cpp_conversion_op>(std::move(scope), std::move(name), detail::parse_comment(cur),
-                                               type, std::move(finfo), std::move(minfo));
+cpp_ptr<cpp_conversion_op> cpp_conversion_op::parse(shared_string scope, cpp_cursor cur)
+{
+    detail::tokenizer tokens(cur);
+    return parse_conversion_op(std::move(scope), cur, detail::declaration(tokens, parse_function_name(cur)));
 }
 
-cpp_ptr<cpp_constructor> cpp_constructor::parse(cpp_name scope, cpp_cursor cur)
+namespace
 {
-    assert(clang_getCursorKind(cur) == CXCursor_Constructor
-           || clang_getTemplateCursorKind(cur) == CXCursor_Constructor);
+    cpp_ptr<cpp_constructor> parse_constructor(shared_string scope, cpp_cursor cur,
+                                               const detail::declaration &decl)
+    {
+        assert(clang_getCursorKind(cur) == CXCursor_Constructor
+               || clang_getTemplateCursorKind(cur) == CXCursor_Constructor);
 
-    auto name = detail::parse_name(cur);
+        auto name = decl.get_name();
+
+        cpp_function_info info;
+        auto return_type = parse_function_info(cur, decl, info);
+        assert(return_type.get_name().empty());
+        // no noexcept
+        if (info.noexcept_expression.empty())
+            info.noexcept_expression = "false";
 
-    cpp_function_info info;
-    auto return_type = parse_function_info(cur, name, info);
-    assert(return_type.get_name().empty());
-    // no noexcept
-    if (info.noexcept_expression.empty())
-        info.noexcept_expression = "false";
+        auto result =  detail::make_ptr<cpp_constructor>(std::move(scope), std::move(name), detail::parse_comment(cur),
+                                                         std::move(info));
+        parse_parameters(result.get(), cur);
+        return result;
+    }
+}
 
-    auto result =  detail::make_ptr<cpp_constructor>(std::move(scope), std::move(name), detail::parse_comment(cur),
-                                                     std::move(info));
-    parse_parameters(result.get(), cur);
-    return result;
+cpp_ptr<cpp_constructor> cpp_constructor::parse(shared_string scope, cpp_cursor cur)
+{
+    detail::tokenizer tokens(cur);
+    return parse_constructor(std::move(scope), cur, detail::declaration(tokens, parse_function_name(cur)));
 }
 
-cpp_ptr<cpp_destructor> cpp_destructor::parse(cpp_name scope, cpp_cursor cur)
+namespace
 {
-    assert(clang_getCursorKind(cur) == CXCursor_Destructor
-           || clang_getTemplateCursorKind(cur) == CXCursor_Destructor);
+    cpp_ptr<cpp_destructor> parse_destructor(shared_string scope, cpp_cursor cur,
+                                             const detail::declaration &decl)
+    {
+        assert(clang_getCursorKind(cur) == CXCursor_Destructor
+               || clang_getTemplateCursorKind(cur) == CXCursor_Destructor);
 
-    auto name = detail::parse_name(cur);
+        auto name = decl.get_name();
 
-    cpp_function_info info;
-    cpp_member_function_info minfo;
-    auto return_type = detail::parse_function_info(cur, name, info, minfo);
-    assert(return_type.empty());
-    assert(minfo.cv_qualifier == cpp_cv(0));
-    assert(minfo.ref_qualifier == cpp_ref_none);
+        cpp_function_info info;
+        cpp_member_function_info minfo;
+        auto return_type = detail::parse_function_info(cur, decl, info, minfo);
+        assert(return_type.empty());
+        assert(minfo.cv_qualifier == cpp_cv(0));
+        assert(minfo.ref_qualifier == cpp_ref_none);
 
-    // no noexcept
-    if (info.noexcept_expression.empty())
-        info.noexcept_expression = "true"; // destructors are implicitly noexcept!
+        // no noexcept
+        if (info.noexcept_expression.empty())
+            info.noexcept_expression = "true"; // destructors are implicitly noexcept!
 
-    return detail::make_ptr<cpp_destructor>(std::move(scope), std::move(name), detail::parse_comment(cur),
-                                            std::move(info), minfo.virtual_flag);
+        return detail::make_ptr<cpp_destructor>(std::move(scope), std::move(name), detail::parse_comment(cur),
+                                                std::move(info), minfo.virtual_flag);
+    }
+}
+
+cpp_ptr<cpp_destructor> cpp_destructor::parse(shared_string scope, cpp_cursor cur)
+{
+    detail::tokenizer tokens(cur);
+    return parse_destructor(std::move(scope), cur, detail::declaration(tokens, parse_function_name(cur)));
 }
@@ -7,9 +7,9 @@
 #include <cassert>
 
 #include <standardese/detail/parse_utils.hpp>
-#include <standardese/detail/search_token.hpp>
 #include <standardese/cpp_cursor.hpp>
 #include <standardese/parser.hpp>
+#include <standardese/string.hpp>
 
 using namespace standardese;
 
@@ -17,12 +17,13 @@ namespace
 {
     bool is_inline_namespace(CXCursor cur, const cpp_name &name)
     {
-        return detail::has_prefix_token(cur, "inline", name.c_str());
+        detail::tokenizer tokens(cur);
+        return detail::declaration(tokens, name).has_prefix(detail::keyword_inline);
     }
 }
 
-cpp_namespace::parser::parser(const cpp_name &scope, cpp_cursor cur)
-: ns_(new cpp_namespace(scope, detail::parse_name(cur), detail::parse_comment(cur)))
+cpp_namespace::parser::parser(shared_string scope, cpp_cursor cur)
+: ns_(new cpp_namespace(std::move(scope), detail::parse_name(cur), detail::parse_comment(cur)))
 {
     assert(clang_getCursorKind(cur) == CXCursor_Namespace);
     if (is_inline_namespace(cur, ns_->get_name()))
@@ -64,7 +65,7 @@ namespace
     }
 }
 
-cpp_ptr<cpp_namespace_alias> cpp_namespace_alias::parse(cpp_name scope, cpp_cursor cur)
+cpp_ptr<cpp_namespace_alias> cpp_namespace_alias::parse(shared_string scope, cpp_cursor cur)
 {
     assert(clang_getCursorKind(cur) == CXCursor_NamespaceAlias);
     cpp_name target, target_scope;
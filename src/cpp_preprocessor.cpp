@@ -4,10 +4,10 @@
 
 #include <standardese/cpp_preprocessor.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 #include <standardese/detail/parse_utils.hpp>
-#include <standardese/detail/search_token.hpp>
 
 using namespace standardese;
 
@@ -15,24 +15,11 @@ cpp_ptr<cpp_inclusion_directive> cpp_inclusion_directive::parse(cpp_cursor cur)
 {
     assert(clang_getCursorKind(cur) == CXCursor_InclusionDirective);
 
-    kind k = local; // set to local because " isn't reached in the tokens
-    auto found = false;
-    detail::visit_tokens(cur, [&](CXToken, const string &spelling)
-    {
-        if (found)
-        {
-            if (spelling == "<")
-                k = system;
-            else if (spelling == "\"")
-                k = local;
-
-            return false;
-        }
-        else if (spelling == "include")
-            found = true;
-
-        return true;
-    });
+    // local unless the file name is in angle brackets, " isn't always reached in the tokens
+    detail::tokenizer tokens(cur);
+    auto include = std::find(tokens.begin(), tokens.end(), detail::keyword_include);
+    auto k = include != tokens.end() && std::next(include) != tokens.end()
+             && *std::next(include) == detail::punctuation_angle_open ? system : local;
 
     return detail::make_ptr<cpp_inclusion_directive>(detail::parse_name(cur), detail::parse_comment(cur), k);
 }
@@ -43,7 +30,8 @@ cpp_ptr<cpp_macro_definition> cpp_macro_definition::parse(cpp_cursor cur)
 
     auto name = detail::parse_name(cur);
     std::string args;
-    auto rep = detail::parse_macro_replacement(cur, name, args);
+    detail::tokenizer tokens(cur);
+    auto rep = detail::parse_macro_replacement(detail::declaration(tokens, name), args);
 
     return detail::make_ptr<cpp_macro_definition>(std::move(name), detail::parse_comment(cur),
                                                   std::move(args), std::move(rep));
@@ -4,22 +4,24 @@
 
 #include <standardese/cpp_template.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 #include <standardese/detail/parse_utils.hpp>
-#include <standardese/detail/search_token.hpp>
 #include <standardese/cpp_function.hpp>
 #include <standardese/string.hpp>
 
 using namespace standardese;
 
-cpp_name cpp_template_ref::get_full_name() const
+cpp_template_ref::cpp_template_ref(cpp_cursor tmplate, cpp_name given)
+: given_(std::move(given)), declaration_(tmplate)
 {
-    string spelling(clang_getCursorSpelling(declaration_));
-    assert(spelling.get() == given_);
+    if (clang_Cursor_isNull(declaration_))
+        return;
 
+    string spelling(clang_getCursorSpelling(declaration_));
     auto scope = detail::parse_scope(declaration_);
-    return scope.empty() ? spelling.get() : scope + "::" + spelling.get();
+    full_ = scope.empty() ? spelling.get() : scope + "::" + spelling.get();
 }
 
 cpp_ptr<cpp_template_parameter> cpp_template_parameter::try_parse(cpp_cursor cur)
@@ -43,10 +45,13 @@ cpp_ptr<cpp_template_type_parameter> cpp_template_type_parameter::parse(cpp_curs
 {
     assert(clang_getCursorKind(cur) == CXCursor_TemplateTypeParameter);
 
+    detail::tokenizer tokens(cur);
+    detail::declaration decl(tokens, detail::parse_name(cur));
+
     bool is_variadic;
-    auto def_name = detail::parse_template_type_default(cur, is_variadic);
+    auto def_name = detail::parse_template_type_default(decl, is_variadic);
 
-    return detail::make_ptr<cpp_template_type_parameter>(detail::parse_name(cur), detail::parse_comment(cur),
+    return detail::make_ptr<cpp_template_type_parameter>(decl.get_name(), detail::parse_comment(cur),
                                                          cpp_type_ref({}, def_name), is_variadic);
 }
 
@@ -54,14 +59,16 @@ cpp_ptr<cpp_non_type_template_parameter> cpp_non_type_template_parameter::parse(
 {
     assert(clang_getCursorKind(cur) == CXCursor_NonTypeTemplateParameter);
 
-    auto name = detail::parse_name(cur);
+    detail::tokenizer tokens(cur);
+    detail::declaration decl(tokens, detail::parse_name(cur));
+
     bool is_variadic;
     std::string def;
-    auto type_given = detail::parse_template_non_type_type(cur, name, def, is_variadic);
+    auto type_given = detail::parse_template_non_type_type(decl, def, is_variadic);
 
     auto type = clang_getCursorType(cur);
 
-    return detail::make_ptr<cpp_non_type_template_parameter>(std::move(name), detail::parse_comment(cur),
+    return detail::make_ptr<cpp_non_type_template_parameter>(decl.get_name(), detail::parse_comment(cur),
                                                              cpp_type_ref(type, std::move(type_given)), std::move(def),
                                                              is_variadic);
 }
@@ -70,7 +77,8 @@ namespace
 {
     bool is_template_template_variadic(cpp_cursor cur, const cpp_name &name)
     {
-        return detail::has_direct_prefix_token(cur, "...", name.c_str());
+        detail::tokenizer tokens(cur);
+        return detail::declaration(tokens, name).has_prefix(detail::punctuation_ellipsis);
     }
 }
 
@@ -138,7 +146,7 @@ namespace
     }
 }
 
-cpp_ptr<cpp_function_template> cpp_function_template::parse(cpp_name scope, cpp_cursor cur)
+cpp_ptr<cpp_function_template> cpp_function_template::parse(shared_string scope, cpp_cursor cur)
 {
     auto func = cpp_function_base::try_parse(std::move(scope), cur);
     assert(func);
@@ -153,18 +161,22 @@ cpp_ptr<cpp_function_template> cpp_function_template::parse(cpp_name scope, cpp_
 
 cpp_function_template::cpp_function_template(cpp_name template_name, cpp_ptr<cpp_function_base> ptr)
 : cpp_entity(function_template_t, ptr->get_scope(), std::move(template_name), ptr->get_comment()),
-  func_(std::move(ptr))
-{}
+  cpp_entity_container(this), func_(std::move(ptr))
+{
+    set_parent(*func_, *this);
+}
 
-cpp_ptr<cpp_function_template_specialization> cpp_function_template_specialization::parse(cpp_name scope,
+cpp_ptr<cpp_function_template_specialization> cpp_function_template_specialization::parse(shared_string scope,
                                                                                           cpp_cursor cur)
 {
-    auto func = cpp_function_base::try_parse(std::move(scope), cur);
+    detail::tokenizer tokens(cur);
+    detail::declaration decl(tokens, detail::parse_name(cur));
+    auto func = cpp_function_base::try_parse(std::move(scope), cur, decl);
     assert(func);
 
     auto result = detail::make_ptr<cpp_function_template_specialization>("", std::move(func));
 
-    result->set_name(detail::parse_template_specialization_name(cur, result->func_->get_name()));
+    result->set_name(detail::parse_template_specialization_name(decl));
 
     return result;
 }
@@ -173,10 +185,12 @@ cpp_function_template_specialization::cpp_function_template_specialization(cpp_n
                                                                            cpp_ptr<cpp_function_base> ptr)
 : cpp_entity(function_template_specialization_t, ptr->get_scope(), std::move(template_name), ptr->get_comment()),
   func_(std::move(ptr))
-{}
+{
+    set_parent(*func_, *this);
+}
 
-cpp_class_template::parser::parser(cpp_name scope, cpp_cursor cur)
-: parser_(scope, cur), class_(new cpp_class_template(std::move(scope), detail::parse_comment(cur)))
+cpp_class_template::parser::parser(shared_string scope, cpp_cursor cur)
+: parser_(scope, cur), class_(new cpp_class_template(std::move(scope), parser_.get_comment()))
 {
     assert(clang_getCursorKind(cur) == CXCursor_ClassTemplate);
     parse_parameters(class_.get(), cur);
@@ -190,40 +204,61 @@ cpp_entity_ptr cpp_class_template::parser::finish(const standardese::parser &par
         return nullptr;
 
     class_->class_ = cpp_ptr<cpp_class>(ptr);
+    set_parent(*ptr, *class_);
     return std::move(class_);
 }
 
 cpp_class_template::cpp_class_template(cpp_name template_name, cpp_ptr<cpp_class> ptr)
 : cpp_entity(class_template_t, ptr->get_scope(), std::move(template_name), ptr->get_comment()),
-  class_(std::move(ptr))
-{}
+  cpp_entity_container(this), class_(std::move(ptr))
+{
+    set_parent(*class_, *this);
+}
 
-cpp_class_template::cpp_class_template(cpp_name scope, cpp_name comment)
-: cpp_entity(class_template_t, std::move(scope), "", std::move(comment)), class_(nullptr) {}
+cpp_class_template::cpp_class_template(shared_string scope, cpp_raw_comment comment)
+: cpp_entity(class_template_t, std::move(scope), "", std::move(comment)),
+  cpp_entity_container(this), class_(nullptr) {}
 
 bool standardese::is_full_specialization(cpp_cursor cur)
 {
-    bool result;
-    detail::visit_tokens(cur, [&](CXToken, const string &spelling)
+    // only the first token is needed, so don't tokenize the whole declaration
+    auto tu = clang_Cursor_getTranslationUnit(cur);
+    auto begin = clang_getRangeStart(clang_getCursorExtent(cur));
+
+    CXToken *tokens;
+    unsigned no_tokens;
+    clang_tokenize(tu, clang_getRange(begin, begin), &tokens, &no_tokens);
+
+    auto result = false;
+    try
     {
-        result = spelling == "template";
-        return false;
-    });
+        detail::tokenizer first(tu, tokens, tokens + std::min(no_tokens, 1u));
+        result = first.size() == 1u && *first.begin() == detail::keyword_template;
+    }
+    catch (...)
+    {
+        clang_disposeTokens(tu, tokens, no_tokens);
+        throw;
+    }
 
+    clang_disposeTokens(tu, tokens, no_tokens);
     return result;
 }
 
-cpp_class_template_full_specialization::parser::parser(cpp_name scope, cpp_cursor cur)
-: parser_(scope, cur),
-  class_(new cpp_class_template_full_specialization(std::move(scope), detail::parse_comment(cur)))
+cpp_class_template_full_specialization::parser::parser(shared_string scope, cpp_cursor cur)
+: parser(scope, cur, detail::declaration(detail::tokenizer(cur), detail::parse_name(cur))) {}
+
+cpp_class_template_full_specialization::parser::parser(shared_string scope, cpp_cursor cur,
+                                                       const detail::declaration &decl)
+: parser_(scope, cur, decl),
+  class_(new cpp_class_template_full_specialization(std::move(scope), parser_.get_comment()))
 {
     assert(clang_getCursorKind(cur) == CXCursor_ClassDecl
         || clang_getCursorKind(cur) == CXCursor_StructDecl
         || clang_getCursorKind(cur) == CXCursor_UnionDecl);
 
-    auto name = parser_.scope_name();
-    class_->set_name(detail::parse_template_specialization_name(cur, name));
-    class_->template_ = cpp_template_ref(clang_getSpecializedCursorTemplate(cur), std::move(name));
+    class_->set_name(detail::parse_template_specialization_name(decl));
+    class_->template_ = cpp_template_ref(clang_getSpecializedCursorTemplate(cur), decl.get_name());
 }
 
 cpp_entity_ptr cpp_class_template_full_specialization::parser::finish(const standardese::parser &par)
@@ -233,6 +268,7 @@ cpp_entity_ptr cpp_class_template_full_specialization::parser::finish(const stan
         return nullptr;
 
     class_->class_ = cpp_ptr<cpp_class>(ptr);
+    set_parent(*ptr, *class_);
     return std::move(class_);
 }
 
@@ -240,21 +276,27 @@ cpp_class_template_full_specialization::cpp_class_template_full_specialization(c
                                                                                cpp_ptr<cpp_class> ptr,
                                                                                cpp_template_ref primary)
 : cpp_entity(class_template_full_specialization_t, ptr->get_scope(), std::move(template_name), ptr->get_comment()),
-  class_(std::move(ptr)), template_(std::move(primary)) {}
+  class_(std::move(ptr)), template_(std::move(primary))
+{
+    set_parent(*class_, *this);
+}
 
-cpp_class_template_full_specialization::cpp_class_template_full_specialization(cpp_name scope, cpp_raw_comment comment)
+cpp_class_template_full_specialization::cpp_class_template_full_specialization(shared_string scope, cpp_raw_comment comment)
 : cpp_entity(class_template_full_specialization_t, std::move(scope), "", std::move(comment)), class_(nullptr) {}
 
-cpp_class_template_partial_specialization::parser::parser(cpp_name scope, cpp_cursor cur)
-: parser_(scope, cur),
-  class_(new cpp_class_template_partial_specialization(std::move(scope), detail::parse_comment(cur)))
+cpp_class_template_partial_specialization::parser::parser(shared_string scope, cpp_cursor cur)
+: parser(scope, cur, detail::declaration(detail::tokenizer(cur), detail::parse_name(cur))) {}
+
+cpp_class_template_partial_specialization::parser::parser(shared_string scope, cpp_cursor cur,
+                                                          const detail::declaration &decl)
+: parser_(scope, cur, decl),
+  class_(new cpp_class_template_partial_specialization(std::move(scope), parser_.get_comment()))
 {
     assert(clang_getCursorKind(cur) == CXCursor_ClassTemplatePartialSpecialization);
     parse_parameters(class_.get(), cur);
 
-    auto name = parser_.scope_name();
-    class_->set_name(detail::parse_template_specialization_name(cur, name));
-    class_->template_ = cpp_template_ref(clang_getSpecializedCursorTemplate(cur), std::move(name));
+    class_->set_name(detail::parse_template_specialization_name(decl));
+    class_->template_ = cpp_template_ref(clang_getSpecializedCursorTemplate(cur), decl.get_name());
 }
 
 cpp_entity_ptr cpp_class_template_partial_specialization::parser::finish(const standardese::parser &par)
@@ -264,6 +306,7 @@ cpp_entity_ptr cpp_class_template_partial_specialization::parser::finish(const s
         return nullptr;
 
     class_->class_ = cpp_ptr<cpp_class>(ptr);
+    set_parent(*ptr, *class_);
     return std::move(class_);
 }
 
@@ -271,7 +314,11 @@ cpp_class_template_partial_specialization::cpp_class_template_partial_specializa
                                                                                cpp_ptr<cpp_class> ptr,
                                                                                cpp_template_ref primary)
 : cpp_entity(class_template_partial_specialization_t, ptr->get_scope(), std::move(template_name), ptr->get_comment()),
-  class_(std::move(ptr)), template_(std::move(primary)) {}
+  cpp_entity_container(this), class_(std::move(ptr)), template_(std::move(primary))
+{
+    set_parent(*class_, *this);
+}
 
-cpp_class_template_partial_specialization::cpp_class_template_partial_specialization(cpp_name scope, cpp_raw_comment comment)
-: cpp_entity(class_template_partial_specialization_t, std::move(scope), "", std::move(comment)), class_(nullptr) {}
+cpp_class_template_partial_specialization::cpp_class_template_partial_specialization(shared_string scope, cpp_raw_comment comment)
+: cpp_entity(class_template_partial_specialization_t, std::move(scope), "", std::move(comment)),
+  cpp_entity_container(this), class_(nullptr) {}
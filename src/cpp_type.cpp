@@ -17,23 +17,23 @@ namespace
     cpp_type_ref parse_alias_target(cpp_cursor cur, const cpp_name &name)
     {
         auto type = clang_getTypedefDeclUnderlyingType(cur);
+        detail::tokenizer tokens(cur);
+        detail::declaration decl(tokens, name);
 
         if (clang_getCursorKind(cur) == CXCursor_TypeAliasDecl)
-            return {type, detail::parse_alias_type_name(cur)};
+            return {type, detail::parse_alias_type_name(decl)};
 
         assert(clang_getCursorKind(cur) == CXCursor_TypedefDecl);
 
-        auto str = detail::parse_typedef_type_name(cur, name);
+        auto str = detail::parse_typedef_type_name(decl);
         return {type, str};
     }
 }
 
-cpp_name cpp_type_ref::get_full_name() const
-{
-    return detail::parse_name(type_);
-}
+cpp_type_ref::cpp_type_ref(CXType type, cpp_name given)
+: given_(std::move(given)), full_(detail::parse_name(type)), type_(type) {}
 
-cpp_ptr<cpp_type_alias> cpp_type_alias::parse(const parser &p, const cpp_name &scope, cpp_cursor cur)
+cpp_ptr<cpp_type_alias> cpp_type_alias::parse(const parser &p, shared_string scope, cpp_cursor cur)
 {
     assert(clang_getCursorKind(cur) == CXCursor_TypedefDecl
            || clang_getCursorKind(cur) == CXCursor_TypeAliasDecl);
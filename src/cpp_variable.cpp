@@ -7,19 +7,19 @@
 #include <cassert>
 
 #include <standardese/detail/parse_utils.hpp>
-#include <standardese/detail/search_token.hpp>
 
 using namespace standardese;
 
 namespace
 {
-    cpp_type_ref parse_variable_type(cpp_cursor cur, const cpp_name &name, std::string &initializer)
+    cpp_type_ref parse_variable_type(cpp_cursor cur, const detail::declaration &decl,
+                                     std::string &initializer)
     {
         assert(clang_getCursorKind(cur) == CXCursor_VarDecl
              || clang_getCursorKind(cur) == CXCursor_FieldDecl);
 
         auto type = clang_getCursorType(cur);
-        auto type_name = detail::parse_variable_type_name(cur, name, initializer);
+        auto type_name = detail::parse_variable_type_name(decl, initializer);
 
         return {type, std::move(type_name)};
     }
@@ -50,45 +50,49 @@ namespace
         }
     }
 
-    bool is_variable_thread_local(cpp_cursor cur, const cpp_name &name)
+    bool is_variable_thread_local(const detail::declaration &decl)
     {
-        return detail::has_prefix_token(cur, "thread_local", name.c_str());
+        return decl.has_prefix(detail::keyword_thread_local);
     }
 
-    bool is_variable_mutable(cpp_cursor cur, const cpp_name &name)
+    bool is_variable_mutable(const detail::declaration &decl)
     {
-        return detail::has_prefix_token(cur, "mutable", name.c_str());
+        return decl.has_prefix(detail::keyword_mutable);
     }
 }
 
-cpp_ptr<cpp_variable> cpp_variable::parse(cpp_name scope, cpp_cursor cur)
+cpp_ptr<cpp_variable> cpp_variable::parse(shared_string scope, cpp_cursor cur)
 {
     assert(clang_getCursorKind(cur) == CXCursor_VarDecl);
 
     auto name = detail::parse_name(cur);
+    detail::tokenizer tokens(cur);
+    detail::declaration decl(tokens, name);
 
     std::string initializer;
-    auto type = parse_variable_type(cur, name, initializer);
+    auto type = parse_variable_type(cur, decl, initializer);
 
     auto linkage = convert_linkage(is_variable_static_class(cur), type.get_type(), clang_Cursor_getStorageClass(cur));
-    auto is_thread_local = is_variable_thread_local(cur, name);
+    auto is_thread_local = is_variable_thread_local(decl);
 
     return detail::make_ptr<cpp_variable>(std::move(scope), std::move(name), detail::parse_comment(cur),
                                           std::move(type), std::move(initializer), linkage, is_thread_local);
 }
 
-cpp_ptr<cpp_member_variable> cpp_member_variable::parse(cpp_name scope, cpp_cursor cur)
+cpp_ptr<cpp_member_variable> cpp_member_variable::parse(shared_string scope, cpp_cursor cur)
 {
     assert(clang_getCursorKind(cur) == CXCursor_FieldDecl);
 
     auto name = detail::parse_name(cur);
+    detail::tokenizer tokens(cur);
+    detail::declaration decl(tokens, name);
 
     std::string initializer;
-    auto type = parse_variable_type(cur, name, initializer);
+    auto type = parse_variable_type(cur, decl, initializer);
 
     auto linkage = convert_linkage(false, type.get_type(), clang_Cursor_getStorageClass(cur));
-    auto is_thread_local = is_variable_thread_local(cur, name);
-    auto is_mutable = is_variable_mutable(cur, name);
+    auto is_thread_local = is_variable_thread_local(decl);
+    auto is_mutable = is_variable_mutable(decl);
 
     if (clang_Cursor_isBitField(cur))
     {
@@ -0,0 +1,158 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/detail/declaration.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+using namespace standardese;
+
+namespace
+{
+    using iterator = detail::tokenizer::iterator;
+
+    // skips the <...> starting at begin
+    // only counts the angle brackets outside of other brackets
+    iterator skip_template_brackets(iterator begin, iterator end) STANDARDESE_NOEXCEPT
+    {
+        assert(begin != end && *begin == detail::punctuation_angle_open);
+
+        auto depth = begin->get_depth();
+        auto count = 0;
+        for (auto iter = begin; iter != end; ++iter)
+        {
+            if (iter->get_depth() != depth)
+                continue;
+            else if (*iter == detail::punctuation_angle_open)
+                ++count;
+            else if (*iter == detail::punctuation_angle_close)
+                --count;
+            else if (*iter == detail::punctuation_shift_right)
+                count -= 2;
+
+            if (count <= 0)
+                return std::next(iter);
+        }
+
+        return end;
+    }
+
+    // whether the tokens starting at begin spell name, whitespace in name is ignored
+    // if allow_arguments is true, name may end with template arguments that aren't part of the tokens,
+    // like the name "a<T>" of a destructor ~a() in a class template
+    bool match_name(iterator begin, iterator end, const cpp_name &name, bool allow_arguments,
+                    iterator &name_end) STANDARDESE_NOEXCEPT
+    {
+        auto ptr = name.c_str();
+        while (*ptr == ' ')
+            ++ptr;
+
+        for (auto iter = begin; iter != end && *ptr; ++iter)
+        {
+            if (std::strncmp(iter->data(), ptr, iter->size()) != 0)
+                return false;
+
+            ptr += iter->size();
+            while (*ptr == ' ')
+                ++ptr;
+
+            if (!*ptr || (allow_arguments && *ptr == '<'))
+            {
+                name_end = std::next(iter);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool is_declarator_end(const detail::token &t) STANDARDESE_NOEXCEPT
+    {
+        return t.get_depth() == 0u
+            && (t == detail::punctuation_equal
+             || t == detail::punctuation_colon
+             || t == detail::punctuation_semicolon
+             || t == detail::punctuation_brace_open
+             || t == detail::punctuation_arrow);
+    }
+}
+
+detail::declaration::declaration(const tokenizer &tokens, cpp_name name)
+: declaration(tokens.begin(), tokens.end(), std::move(name)) {}
+
+detail::declaration::declaration(iterator begin, iterator end, cpp_name name)
+: name_(std::move(name)), begin_(begin), prefix_(begin), end_(end),
+  prefix_keywords_(0u), prefix_punctuation_(0u), suffix_keywords_(0u)
+{
+    // template <...>, member templates of class templates have multiple
+    while (prefix_ != end_ && *prefix_ == keyword_template)
+    {
+        ++prefix_;
+        if (prefix_ != end_ && *prefix_ == punctuation_angle_open)
+            prefix_ = skip_template_brackets(prefix_, end_);
+    }
+
+    // the first occurrence of the name, prefer an exact match
+    auto find_name = [&](bool allow_arguments)
+    {
+        for (name_begin_ = prefix_; name_begin_ != end_; ++name_begin_)
+            if (match_name(name_begin_, end_, name_, allow_arguments, name_end_))
+                return true;
+        return false;
+    };
+    if (find_name(false) || find_name(true))
+    {
+        arguments_end_ = name_end_;
+        if (arguments_end_ != end_ && *arguments_end_ == punctuation_angle_open)
+            arguments_end_ = skip_template_brackets(arguments_end_, end_);
+
+        suffix_ = arguments_end_;
+        if (suffix_ != end_ && *suffix_ == punctuation_paren_open)
+            suffix_ = skip_brackets(suffix_, end_);
+    }
+    else
+    {
+        // unnamed, e.g. an unnamed parameter or an anonymous enum
+        name_begin_ = std::find_if(prefix_, end_, is_declarator_end);
+        name_end_ = arguments_end_ = suffix_ = name_begin_;
+    }
+
+    for (auto iter = prefix_; iter != name_begin_; ++iter)
+        if (iter->get_depth() == 0u)
+        {
+            prefix_keywords_ |= 1ul << iter->get_keyword();
+            prefix_punctuation_ |= 1ul << iter->get_punctuation();
+        }
+
+    std::fill(std::begin(punctuation_), std::end(punctuation_), end_);
+    tail_ = end_;
+    for (auto iter = suffix_; iter != end_; ++iter)
+    {
+        if (iter->get_depth() != 0u)
+            continue;
+
+        auto& first = punctuation_[iter->get_punctuation()];
+        if (first == end_)
+            first = iter;
+
+        if (tail_ == end_ && is_declarator_end(*iter))
+            tail_ = iter;
+        else if (tail_ == end_)
+            suffix_keywords_ |= 1ul << iter->get_keyword();
+    }
+}
+
+detail::tokenizer::iterator detail::skip_brackets(tokenizer::iterator begin, tokenizer::iterator end)
+                                                  STANDARDESE_NOEXCEPT
+{
+    // the closing bracket is the next token with the same depth
+    assert(begin != end);
+    auto depth = begin->get_depth();
+    for (auto iter = std::next(begin); iter != end; ++iter)
+        if (iter->get_depth() == depth)
+            return std::next(iter);
+    return end;
+}
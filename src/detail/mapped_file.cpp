@@ -0,0 +1,111 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/detail/mapped_file.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+    #include <fstream>
+    #include <iterator>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+using namespace standardese;
+
+namespace
+{
+    long get_time_nsec(const struct stat &info) STANDARDESE_NOEXCEPT
+    {
+#if defined(_WIN32)
+        (void)info;
+        return 0;
+#elif defined(__APPLE__)
+        return info.st_mtimespec.tv_nsec;
+#else
+        return info.st_mtim.tv_nsec;
+#endif
+    }
+}
+
+bool detail::mapped_file::file_id::operator==(const file_id &other) const STANDARDESE_NOEXCEPT
+{
+    return device == other.device && inode == other.inode && size == other.size
+        && time == other.time && time_nsec == other.time_nsec;
+}
+
+bool detail::mapped_file::is_modified() const STANDARDESE_NOEXCEPT
+{
+    struct stat info;
+    if (::stat(path_.c_str(), &info) != 0)
+        return true;
+
+    file_id id{info.st_dev, info.st_ino, static_cast<unsigned long long>(info.st_size),
+               info.st_mtime, get_time_nsec(info)};
+    return !(id == id_);
+}
+
+detail::mapped_file::mapped_file(const char *path)
+: path_(path)
+{
+    auto error = [&](const char *msg)
+    {
+        return std::runtime_error(std::string(msg) + " '" + path + "'");
+    };
+
+#if defined(_WIN32)
+    struct stat info;
+    std::ifstream in(path, std::ios::binary);
+    if (!in || ::stat(path, &info) != 0)
+        throw error("unable to open file");
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    size_ = content.size();
+    time_ = info.st_mtime;
+    id_ = {info.st_dev, info.st_ino, static_cast<unsigned long long>(info.st_size), time_, get_time_nsec(info)};
+    auto owner = std::make_shared<std::string>(std::move(content));
+    data_ = std::shared_ptr<const char>(owner, owner->data());
+#else
+    auto fd = ::open(path, O_RDONLY);
+    if (fd == -1)
+        throw error("unable to open file");
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        throw error("unable to read file");
+    }
+    time_ = info.st_mtime;
+    id_ = {info.st_dev, info.st_ino, static_cast<unsigned long long>(info.st_size), time_, get_time_nsec(info)};
+
+    // a single buffer for all of the contents
+    auto owner = std::make_shared<std::string>(std::size_t(info.st_size), '\0');
+    size_ = 0u;
+    while (size_ != owner->size())
+    {
+        auto result = ::read(fd, &(*owner)[size_], owner->size() - size_);
+        if (result == -1 && errno == EINTR)
+            continue;
+        else if (result == -1)
+        {
+            ::close(fd);
+            throw error("unable to read file");
+        }
+        else if (result == 0)
+            // truncated since fstat()
+            break;
+        size_ += std::size_t(result);
+    }
+    ::close(fd);
+
+    owner->resize(size_);
+    data_ = std::shared_ptr<const char>(owner, owner->data());
+#endif
+}
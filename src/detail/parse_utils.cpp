@@ -3,10 +3,13 @@
 // found in the top-level directory of this distribution.
 
 #include <standardese/detail/parse_utils.hpp>
-#include <standardese/detail/search_token.hpp>
+#include <standardese/detail/source_file.hpp>
+#include <standardese/string.hpp>
 #include <standardese/cpp_function.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
 using namespace standardese;
 
@@ -59,23 +62,44 @@ cpp_name detail::parse_class_name(cpp_cursor cur)
 
 cpp_raw_comment detail::parse_comment(cpp_cursor cur)
 {
+    auto range = clang_Cursor_getCommentRange(cur);
+    if (clang_Range_isNull(range))
+        return {};
+
+    // refer to the comment in the source file instead of copying it
+    CXFile file;
+    unsigned begin, end;
+    clang_getSpellingLocation(clang_getRangeStart(range), &file, nullptr, nullptr, &begin);
+    if (file && get_source_offset(clang_getRangeEnd(range), file, end) && begin <= end)
+    {
+        auto source = get_source_file(file);
+        if (source && end <= source->size())
+            return cpp_raw_comment(source->share(), source->data() + begin, end - begin);
+    }
+
     string str(clang_Cursor_getRawCommentText(cur));
     return cpp_raw_comment(str.get());
 }
 
 cpp_name detail::parse_scope(cpp_cursor cur)
 {
-    cpp_name result;
+    // collect the names from the innermost scope outwards
+    // and join them afterwards, prepending would be quadratic
+    std::vector<cpp_name> names;
     cur = clang_getCursorSemanticParent(cur);
     while (!clang_isInvalid(clang_getCursorKind(cur)) && !clang_isTranslationUnit(clang_getCursorKind(cur)))
     {
-        auto str = detail::parse_name(cur);
-        if (result.empty())
-            result = str;
-        else
-            result = str + "::" + result;
+        names.push_back(detail::parse_name(cur));
         cur = clang_getCursorSemanticParent(cur);
     }
+
+    cpp_name result;
+    for (auto iter = names.rbegin(); iter != names.rend(); ++iter)
+    {
+        if (!result.empty())
+            result += "::";
+        result += *iter;
+    }
     return result;
 }
 
@@ -103,137 +127,88 @@ namespace
         return false;
     }
 
-    void cat_token(cpp_name &result, const char *spelling)
+    void cat_token(cpp_name &result, const detail::token &spelling)
     {
-        if (!result.empty() && needs_whitespace(result.back(), *spelling))
+        if (!result.empty() && needs_whitespace(result.back(), *spelling.data()))
             result += ' ';
-        result += spelling;
+        result.append(spelling.data(), spelling.size());
     }
-}
 
-cpp_name detail::parse_typedef_type_name(cpp_cursor cur, const cpp_name &name)
-{
-    cpp_name result;
-    visit_tokens(cur, [&](CXToken, const string &spelling)
+    void cat_tokens(cpp_name &result, const detail::token_range &tokens)
     {
-        if (spelling == name.c_str() || spelling == "typedef")
-            return true;
-
-        cat_token(result, spelling);
-        return true;
-    });
+        for (auto& spelling : tokens)
+            cat_token(result, spelling);
+    }
 
-    return result;
+    // everything before the name, including template parameters
+    detail::token_range before_name(const detail::declaration &decl) STANDARDESE_NOEXCEPT
+    {
+        return {decl.get_tokens().begin(), decl.get_name_tokens().begin()};
+    }
 }
 
-cpp_name detail::parse_variable_type_name(cpp_cursor cur, const cpp_name &name, std::string &initializer)
+cpp_name detail::parse_typedef_type_name(const declaration &decl)
 {
+    // the name can be in the middle: typedef void(*name)(int);
     cpp_name result;
-    auto in_type = true, was_bitfield = false;
-    visit_tokens(cur, [&](CXToken, const string &spelling)
-    {
-        if (spelling == name.c_str()
-          || spelling == "extern"
-          || spelling == "static"
-          || spelling == "thread_local"
-          || spelling == "mutable")
-            return true;
-        else if (spelling == ":")
-            was_bitfield = true;
-        else if (was_bitfield)
-            was_bitfield = false;
-        else if (spelling == "=")
-            in_type = false;
-        else
-            cat_token(in_type ? result : initializer, spelling);
-
-        return true;
-    });
+    for (auto& spelling : before_name(decl))
+        if (spelling != keyword_typedef)
+            cat_token(result, spelling);
+    cat_tokens(result, {decl.get_name_tokens().end(), decl.get_tokens().end()});
 
     return result;
 }
 
-cpp_name detail::parse_alias_type_name(cpp_cursor cur)
+cpp_name detail::parse_variable_type_name(const declaration &decl, std::string &initializer)
 {
+    // the type ends at the bitfield width or at the initializer
+    auto equal = decl.find(punctuation_equal);
+    auto type_end = std::min(decl.find(punctuation_colon), equal);
+
     cpp_name result;
-    auto found = false;
-    visit_tokens(cur, [&](CXToken, const string &spelling)
-    {
-        if (found)
+    for (auto& spelling : before_name(decl))
+        if (spelling != keyword_extern
+         && spelling != keyword_static
+         && spelling != keyword_thread_local
+         && spelling != keyword_mutable)
             cat_token(result, spelling);
-        else if (spelling == "=")
-            found = true;
+    cat_tokens(result, {decl.get_name_tokens().end(), type_end});
 
-        return true;
-    });
+    if (equal != decl.get_tokens().end())
+        cat_tokens(initializer, {std::next(equal), decl.get_tokens().end()});
 
     return result;
 }
 
-cpp_name detail::parse_enum_type_name(cpp_cursor cur, bool &definition)
+cpp_name detail::parse_alias_type_name(const declaration &decl)
 {
-    definition = false;
-
     cpp_name result;
-    auto found = false;
-    visit_tokens(cur, [&](CXToken, const string &spelling)
-    {
-        if (!found && spelling == ":")
-        {
-            found = true;
-            return true;
-        }
-        else if (spelling == "{")
-        {
-            definition = true;
-            return false;
-        }
-        else if (spelling == ";")
-            return false;
-        else if (!found)
-            return true;
-
-        cat_token(result, spelling);
-        return true;
-    });
+    auto equal = decl.find(punctuation_equal);
+    if (equal != decl.get_tokens().end())
+        cat_tokens(result, {std::next(equal), decl.get_tokens().end()});
 
     return result;
 }
 
-namespace
+cpp_name detail::parse_enum_type_name(const declaration &decl, bool &definition)
 {
-    // compares until whitespace or template
-    bool token_equal(const string &token, const char* &ptr)
-    {
-        auto save = ptr;
-        auto token_ptr = token.get();
-        while (true)
-        {
-            if (!*token_ptr)
-                return true;
-            else if (!*ptr)
-                break;
-            else if (*ptr == ' ' || *ptr == '<')
-                return true;
-            else if (*token_ptr != *ptr)
-                break;
-            ++token_ptr;
-            ++ptr;
-        }
-        ptr = save;
-        return false;
-    }
+    auto colon = decl.find(punctuation_colon);
+    auto brace = decl.find(punctuation_brace_open);
+    auto body = std::min(brace, decl.find(punctuation_semicolon));
+    definition = body != decl.get_tokens().end() && body == brace;
+
+    cpp_name result;
+    if (colon < body)
+        cat_tokens(result, {std::next(colon), body});
+
+    return result;
 }
 
-cpp_name detail::parse_function_info(cpp_cursor cur, const cpp_name &name,
+cpp_name detail::parse_function_info(cpp_cursor cur, const declaration &decl,
                                      cpp_function_info &finfo,
                                      cpp_member_function_info &minfo)
 {
     cpp_name result;
-    auto bracket_count = 0;
-    auto start_parameters = 0;
-
-    auto ptr = name.c_str();
 
     enum
     {
@@ -242,171 +217,94 @@ cpp_name detail::parse_function_info(cpp_cursor cur, const cpp_name &name,
         decltype_return
     } ret = normal_return;
 
-    enum
+    // everything before the function name
+    for (auto& spelling : decl.get_prefix())
     {
-        prefix,
-        template_parameters,
-        parameters,
-        suffix,
-        noexcept_expression,
-        trailing_return,
-        definition,
-    } state = prefix;
+        if (spelling == keyword_extern
+            || spelling == keyword_static)
+            continue; // skip leading ignored keywords
+        else if (spelling == keyword_constexpr)
+            finfo.set_flag(cpp_constexpr_fnc); // add constepxr flag
+        else if (spelling == keyword_explicit)
+            finfo.set_flag(cpp_explicit_conversion); // add explicit flag
+        else if (spelling == keyword_virtual)
+            minfo.virtual_flag = cpp_virtual_new; // mark virtual
+        else if (ret != decltype_return && spelling == keyword_auto)
+            ret = auto_return; // mark auto return type
+        else
+        {
+            if (spelling == keyword_decltype)
+                ret = decltype_return; // decltype return, allow auto
+            cat_token(result, spelling); // part of return type
+        }
+    }
 
+    // rest of return type, other keywords at the end
     auto was_noexcept = false;
     finfo.noexcept_expression.clear();
 
-    visit_tokens(cur, [&](CXToken, const string &spelling)
+    auto suffix = decl.get_suffix();
+    for (auto iter = suffix.begin(); iter != suffix.end(); ++iter)
     {
-        if (spelling == "(" || spelling == "<")
-            bracket_count++;
-        else if (spelling == ")" || spelling == ">")
-            bracket_count--;
-
-        if (spelling != ")" && bracket_count == 0u && state == noexcept_expression)
-            // no brackets, directly back
-            state = suffix;
-
-        if (state == prefix) // everything before the function name
-        {
-            if (spelling == "extern"
-                || spelling == "static")
-                return true; // skip leading ignored keywords
-            else if (spelling == "operator")
-            {
-                assert(name.compare(0, 8, "operator") == 0);
-                ptr += 8; // bump pointer for comparison
-                while (*ptr == ' ')
-                    ++ptr;
-            }
-            else if (spelling == "constexpr")
-                finfo.set_flag(cpp_constexpr_fnc); // add constepxr flag
-            else if (spelling == "explicit")
-                finfo.set_flag(cpp_explicit_conversion); // add explicit flag
-            else if (spelling == "virtual")
-                minfo.virtual_flag = cpp_virtual_new; // mark virtual
-            else if (ret != decltype_return && spelling == "auto")
-                ret = auto_return; // mark auto return type
-            else if (spelling == "template")
-            {
-                state = template_parameters; // template parameters begin
-                start_parameters = bracket_count;
-            }
-            // parameter begin
-            else if (token_equal(spelling, ptr)) // consume only up to whitespace for conversion op
-            {
-                if (!*ptr || *ptr == '<')
-                {
-                    state = parameters; // enter parameters
-                    start_parameters = bracket_count;
-                }
-            }
-            // normal case
-            else
-            {
-                if (spelling == "decltype")
-                    ret = decltype_return; // decltype return, allow auto
-                cat_token(result, spelling); // part of return type
-            }
-        }
-        else if (state == template_parameters) // template parameters
-        {
-            if (bracket_count == start_parameters)
-                state = prefix; // go to prefix
-        }
-        else if (state == parameters) // parameter part
-        {
-            if (bracket_count == start_parameters
-                && spelling != ">")
-                // go to suffix if outside
-                // note that if the bracket_count resets due to >
-                // we're just finished with a specialization part:
-                // void func<int>();
-                // so don't switch then
-                state = suffix;
-        }
-        else if (state == suffix) // rest of return type, other keywords at the end
-        {
-            // first handle state switch conditions
-            if (spelling == "->")
-            {
-                state = trailing_return; // trailing return type
-                return true; // consume token
-            }
-            else if (spelling == ";" || spelling == "{" || spelling == ":")
-                return false; // finish with declaration part
-            else if (spelling == "=")
-            {
-                state = definition; // enter definition
-                return true;
-            }
-            else if (spelling == "noexcept")
-            {
-                state = noexcept_expression; // enter noexcept expression
-                was_noexcept = true;
-                return true;
-            }
-
-            // count brackets to handle: int (*f(int a))(volatile char);
+        auto& spelling = *iter;
+        if (spelling.get_depth() != 0u)
+            // inside the parameters of a function ptr return type:
+            // int (*f(int a))(volatile char);
             // i.e. don't mistake the cv there for a cv specifier
-            // outside of the parameters of a function ptr return type
-            if (bracket_count == 0)
-            {
-                if (spelling == "const")
-                    minfo.set_cv(cpp_cv_const); // const member function
-                else if (spelling == "volatile")
-                    minfo.set_cv(cpp_cv_volatile); // volatile member function
-                else if (spelling == "&")
-                    minfo.ref_qualifier = cpp_ref_lvalue; // lvalue member function
-                else if (spelling == "&&")
-                    minfo.ref_qualifier = cpp_ref_rvalue; // rvalue member function
-                else if (spelling == "override")
-                    minfo.virtual_flag = cpp_virtual_overriden; // make override
-                else if (spelling == "final")
-                    minfo.virtual_flag = cpp_virtual_final; // make final
-                else
-                    cat_token(result, spelling); // part of return type
-            }
-            else
-                cat_token(result, spelling); // part of return type
-        }
-        else if (state == noexcept_expression) // handles the (...) part of noexcept(...)
+            cat_token(result, spelling);
+        else if (spelling == keyword_noexcept)
         {
-            if (bracket_count > 0 && (bracket_count != 1 || spelling != "("))
-                // if inside the noexcept(...)
-                cat_token(finfo.noexcept_expression, spelling);
-            else if (bracket_count == 0)
+            was_noexcept = true;
+
+            auto next = std::next(iter);
+            if (next != suffix.end() && *next == punctuation_paren_open)
             {
-                assert(spelling == ")");
-                state = suffix; // continue with suffix
+                // the (...) part of noexcept(...)
+                auto close = skip_brackets(next, suffix.end());
+                cat_tokens(finfo.noexcept_expression, {std::next(next), std::prev(close)});
+                iter = std::prev(close);
             }
         }
-        else if (state == trailing_return) // trailing return type
-        {
-            if (spelling == "=")
-                state = definition; // enter definition
-            else if (spelling == ";" || spelling == "{")
-                return false; // finished with body
-            else
-                cat_token(result, spelling); // part of return type
-        }
-        else if (state == definition) // deleted, defaulted, pure virtual
-        {
-            if (spelling == "delete")
-                finfo.definition = cpp_function_definition_deleted;
-            else if (spelling == "default")
-                finfo.definition = cpp_function_definition_defaulted;
-            else if (spelling == "0")
-                minfo.virtual_flag = cpp_virtual_pure; // make pure virtual
-            else
-                assert(false);
-            return false; // nothing comes after this
-        }
+        else if (spelling == keyword_const)
+            minfo.set_cv(cpp_cv_const); // const member function
+        else if (spelling == keyword_volatile)
+            minfo.set_cv(cpp_cv_volatile); // volatile member function
+        else if (spelling == punctuation_amp)
+            minfo.ref_qualifier = cpp_ref_lvalue; // lvalue member function
+        else if (spelling == punctuation_amp_amp)
+            minfo.ref_qualifier = cpp_ref_rvalue; // rvalue member function
+        else if (spelling == keyword_override)
+            minfo.virtual_flag = cpp_virtual_overriden; // make override
+        else if (spelling == keyword_final)
+            minfo.virtual_flag = cpp_virtual_final; // make final
         else
-            assert(false);
+            cat_token(result, spelling); // part of return type
+    }
 
-        return true;
-    });
+    auto tail = decl.get_tail();
+    auto iter = tail.begin();
+    if (iter != tail.end() && *iter == punctuation_arrow)
+    {
+        // trailing return type
+        auto last = std::min(decl.find(punctuation_equal),
+                             std::min(decl.find(punctuation_semicolon), decl.find(punctuation_brace_open)));
+        cat_tokens(result, {std::next(iter), last});
+        iter = last;
+    }
+
+    if (iter != tail.end() && *iter == punctuation_equal && std::next(iter) != tail.end())
+    {
+        // deleted, defaulted, pure virtual
+        auto& spelling = *std::next(iter);
+        if (spelling == keyword_delete)
+            finfo.definition = cpp_function_definition_deleted;
+        else if (spelling == keyword_default)
+            finfo.definition = cpp_function_definition_defaulted;
+        else if (spelling.get_kind() == CXToken_Literal)
+            minfo.virtual_flag = cpp_virtual_pure; // make pure virtual
+        else
+            assert(false);
+    }
 
     if (ret == auto_return && result.empty())
         // deduced return type
@@ -448,129 +346,65 @@ namespace
     }
 }
 
-cpp_name detail::parse_template_type_default(cpp_cursor cur, bool &variadic)
+cpp_name detail::parse_template_type_default(const declaration &decl, bool &variadic)
 {
-    cpp_name result;
-    auto found = false;
-    variadic = false;
-    visit_tokens(cur, [&](CXToken, const string &spelling)
-    {
-        if (found)
-            cat_token(result, spelling);
-        else
-        {
-            if (spelling == "=")
-                found = true;
-            else if (spelling == "...")
-                variadic = true;
-        }
+    variadic = decl.has_prefix(punctuation_ellipsis);
 
-        return true;
-    });
+    cpp_name result;
+    auto equal = decl.find(punctuation_equal);
+    if (equal != decl.get_tokens().end())
+        cat_tokens(result, {std::next(equal), decl.get_tokens().end()});
 
     unmunch(result);
 
     return result;
 }
 
-cpp_name detail::parse_template_non_type_type(cpp_cursor cur, const cpp_name &name, std::string &def, bool &variadic)
+cpp_name detail::parse_template_non_type_type(const declaration &decl, std::string &def, bool &variadic)
 {
+    auto equal = decl.find(punctuation_equal);
+
+    // the ellipsis can be inside the declarator: int (*... f)(float)
     cpp_name result;
-    auto in_type = true, after_name = false;
     variadic = false;
-    visit_tokens(cur, [&](CXToken, const string &spelling)
-    {
-        if (spelling == name.c_str())
-            after_name = true;
-        else if (spelling == "=")
-            in_type = false;
-        else if (!after_name && spelling == "...")
+    for (auto& spelling : before_name(decl))
+        if (spelling == punctuation_ellipsis)
             variadic = true;
         else
-            cat_token(in_type ? result : def, spelling);
+            cat_token(result, spelling);
+    cat_tokens(result, {decl.get_name_tokens().end(), equal});
 
-        return true;
-    });
+    if (equal != decl.get_tokens().end())
+        cat_tokens(def, {std::next(equal), decl.get_tokens().end()});
 
     unmunch(def);
 
     return result;
 }
 
-cpp_name detail::parse_template_specialization_name(cpp_cursor cur, const cpp_name &name)
+cpp_name detail::parse_template_specialization_name(const declaration &decl)
 {
-    cpp_name result = name;
-
-    auto found = false;
-    auto bracket_count = 0;
-    visit_tokens(cur, [&](CXToken, const string &spelling)
-    {
-        if (found)
-        {
-            if (spelling == "<")
-                ++bracket_count;
-            else if (spelling == ">")
-                --bracket_count;
-
-            cat_token(result, spelling);
-
-            if (bracket_count == 0)
-                return false;
-        }
-        else
-            found = spelling.get() == name;
-
-        return true;
-    });
+    cpp_name result = decl.get_name();
+    cat_tokens(result, decl.get_template_arguments());
 
     return result;
 }
 
-std::string detail::parse_macro_replacement(cpp_cursor cur, const cpp_name &name, std::string &args)
+std::string detail::parse_macro_replacement(const declaration &decl, std::string &args)
 {
-    std::string result;
     args.clear();
 
-    enum
+    // the parameters must directly follow the name
+    auto replacement = decl.get_name_tokens().end();
+    auto parameters = decl.get_parameters();
+    if (!parameters.empty() && parameters.begin() == replacement)
     {
-        prefix,
-        arguments,
-        replacement
-    } state = prefix;
-    auto require_bracket = false;
-
-    detail::visit_tokens(cur, [&](CXToken, const string &spelling)
-    {
-        if (state == prefix && spelling.get() == name)
-        {
-            state = arguments;
-            require_bracket = true;
-        }
-        else if (state == arguments)
-        {
-            if (require_bracket && spelling != "(")
-            {
-                // part of replacement
-                cat_token(result, spelling);
-                state = replacement;
-            }
-            else if (spelling == ")")
-            {
-                cat_token(args, spelling);
-                state = replacement;
-            }
-            else
-                cat_token(args, spelling);
-
-            require_bracket = false;
-        }
-        else if (state == replacement)
-            cat_token(result, spelling);
-        else
-            assert(false);
+        cat_tokens(args, parameters);
+        replacement = parameters.end();
+    }
 
-        return true;
-    });
+    std::string result;
+    cat_tokens(result, {replacement, decl.get_tokens().end()});
 
     return result;
 }
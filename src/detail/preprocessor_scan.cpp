@@ -0,0 +1,153 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/detail/preprocessor_scan.hpp>
+
+#include <standardese/detail/mapped_file.hpp>
+#include <standardese/detail/parse_utils.hpp>
+#include <standardese/detail/tokenizer.hpp>
+#include <standardese/cpp_preprocessor.hpp>
+
+using namespace standardese;
+
+namespace
+{
+    bool is_space(char c) STANDARDESE_NOEXCEPT
+    {
+        return c == ' ' || c == '\t' || c == '\v' || c == '\f';
+    }
+
+    // whether the character at offset is the first non-whitespace character of its line
+    bool starts_line(const char *data, unsigned offset) STANDARDESE_NOEXCEPT
+    {
+        while (offset != 0u && is_space(data[offset - 1]))
+            --offset;
+        return offset == 0u || data[offset - 1] == '\n' || data[offset - 1] == '\r';
+    }
+
+    // returns the offset of the newline ending the directive starting at offset
+    unsigned get_directive_end(const char *data, unsigned size, unsigned offset) STANDARDESE_NOEXCEPT
+    {
+        for (; offset != size; ++offset)
+            if (data[offset] == '\n')
+            {
+                auto last = offset;
+                if (last != 0u && data[last - 1] == '\r')
+                    --last;
+                if (last == 0u || data[last - 1] != '\\')
+                    return offset;
+            }
+        return size;
+    }
+
+    unsigned get_offset(CXTranslationUnit tu, CXToken token) STANDARDESE_NOEXCEPT
+    {
+        unsigned offset;
+        clang_getSpellingLocation(clang_getTokenLocation(tu, token), nullptr, nullptr, nullptr, &offset);
+        return offset;
+    }
+
+    using token_iterator = detail::tokenizer::iterator;
+
+    cpp_entity_ptr parse_inclusion_directive(token_iterator iter, token_iterator end)
+    {
+        if (iter == end)
+            return nullptr;
+        else if (*iter == detail::punctuation_angle_open)
+        {
+            // the file name consists of multiple tokens
+            std::string file_name;
+            for (++iter; iter != end && *iter != detail::punctuation_angle_close; ++iter)
+                file_name += iter->str();
+            return detail::make_ptr<cpp_inclusion_directive>(std::move(file_name), cpp_raw_comment(),
+                                                             cpp_inclusion_directive::system);
+        }
+        else if (iter->get_kind() == CXToken_Literal && iter->size() >= 2u && iter->data()[0] == '"')
+        {
+            std::string file_name(iter->data() + 1, iter->size() - 2u);
+            return detail::make_ptr<cpp_inclusion_directive>(std::move(file_name), cpp_raw_comment(),
+                                                             cpp_inclusion_directive::local);
+        }
+
+        // included through a macro
+        return nullptr;
+    }
+
+    cpp_entity_ptr parse_macro_definition(token_iterator iter, token_iterator end)
+    {
+        if (iter == end
+            || (iter->get_kind() != CXToken_Identifier && iter->get_kind() != CXToken_Keyword))
+            return nullptr;
+
+        detail::declaration decl(iter, end, iter->str());
+        std::string args;
+        auto rep = detail::parse_macro_replacement(decl, args);
+
+        return detail::make_ptr<cpp_macro_definition>(decl.get_name(), cpp_raw_comment(),
+                                                      std::move(args), std::move(rep));
+    }
+
+    // begin is the token after the '#'
+    cpp_entity_ptr parse_directive(CXTranslationUnit tu, CXToken *begin, CXToken *end)
+    {
+        detail::tokenizer tokens(tu, begin, end);
+        if (tokens.begin() == tokens.end())
+            return nullptr;
+        else if (*tokens.begin() == detail::keyword_define)
+            return parse_macro_definition(std::next(tokens.begin()), tokens.end());
+        else if (*tokens.begin() == detail::keyword_include)
+            return parse_inclusion_directive(std::next(tokens.begin()), tokens.end());
+        return nullptr;
+    }
+}
+
+std::vector<detail::preprocessor_entity> detail::scan_preprocessor(CXTranslationUnit tu, CXFile file,
+                                                                   const mapped_file &source)
+{
+    std::vector<preprocessor_entity> result;
+
+    auto data = source.data();
+    auto size = unsigned(source.size());
+    if (size == 0u)
+        return result;
+
+    auto range = clang_getRange(clang_getLocationForOffset(tu, file, 0u),
+                                clang_getLocationForOffset(tu, file, size));
+
+    CXToken *tokens;
+    unsigned no_tokens;
+    clang_tokenize(tu, range, &tokens, &no_tokens);
+
+    try
+    {
+        for (auto i = 0u; i < no_tokens; ++i)
+        {
+            if (clang_getTokenKind(tokens[i]) != CXToken_Punctuation)
+                continue;
+
+            auto offset = get_offset(tu, tokens[i]);
+            if (offset >= size || data[offset] != '#' || !starts_line(data, offset))
+                continue;
+
+            // all tokens until the end of the line belong to the directive
+            auto end = get_directive_end(data, size, offset);
+            auto last = i + 1;
+            while (last != no_tokens && get_offset(tu, tokens[last]) < end)
+                ++last;
+
+            auto entity = parse_directive(tu, tokens + i + 1, tokens + last);
+            if (entity)
+                result.emplace_back(offset, std::move(entity));
+            i = last - 1;
+        }
+    }
+    catch (...)
+    {
+        clang_disposeTokens(tu, tokens, no_tokens);
+        throw;
+    }
+    clang_disposeTokens(tu, tokens, no_tokens);
+
+    return result;
+}
@@ -0,0 +1,73 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/detail/source_file.hpp>
+
+#include <ctime>
+#include <stdexcept>
+#include <string>
+
+#include <standardese/string.hpp>
+
+using namespace standardese;
+
+namespace
+{
+    thread_local detail::source_file_scope *current_scope = nullptr;
+}
+
+std::shared_ptr<const detail::mapped_file> detail::get_source_file(CXFile file)
+{
+    for (auto scope = current_scope; scope; scope = scope->prev_)
+        if (clang_File_isEqual(scope->file_, file))
+            return scope->source_;
+
+    struct cache
+    {
+        std::string name;
+        std::time_t time;
+        std::shared_ptr<const mapped_file> source;
+    };
+    // consecutive cursors are almost always in the same file, so cache the last one
+    static thread_local cache last;
+
+    string name(clang_getFileName(file));
+    auto time = clang_getFileTime(file);
+    if (last.name != name.get() || last.time != time
+        || (last.source && last.source->is_modified()))
+    {
+        last.name = name.get();
+        last.time = time;
+        try
+        {
+            last.source = std::make_shared<mapped_file>(name.get());
+            if (last.source->get_time() != time)
+                last.source = nullptr;
+        }
+        catch (std::runtime_error&)
+        {
+            last.source = nullptr;
+        }
+    }
+
+    return last.source;
+}
+
+bool detail::get_source_offset(CXSourceLocation loc, CXFile file, unsigned &offset) STANDARDESE_NOEXCEPT
+{
+    CXFile loc_file;
+    clang_getSpellingLocation(loc, &loc_file, nullptr, nullptr, &offset);
+    return loc_file && clang_File_isEqual(loc_file, file);
+}
+
+detail::source_file_scope::source_file_scope(CXFile file, std::shared_ptr<const mapped_file> source) STANDARDESE_NOEXCEPT
+: file_(file), source_(std::move(source)), prev_(current_scope)
+{
+    current_scope = this;
+}
+
+detail::source_file_scope::~source_file_scope() STANDARDESE_NOEXCEPT
+{
+    current_scope = prev_;
+}
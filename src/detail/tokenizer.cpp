@@ -0,0 +1,272 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/detail/tokenizer.hpp>
+
+#include <standardese/detail/source_file.hpp>
+#include <standardese/string.hpp>
+
+using namespace standardese;
+
+namespace
+{
+    struct keyword_entry
+    {
+        const char *spelling;
+        detail::token_keyword keyword;
+    };
+
+    // perfect hash over the keyword set,
+    // all keywords have at least four characters
+    std::size_t keyword_hash(const char *spelling, std::size_t length) STANDARDESE_NOEXCEPT
+    {
+        auto c1 = static_cast<unsigned char>(spelling[1]);
+        auto c2 = static_cast<unsigned char>(spelling[2]);
+        return (length + 2u * c1 + 44u * c2) % 64u;
+    }
+
+    // indexed by keyword_hash()
+    const keyword_entry keyword_table[64] =
+    {
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {"noexcept", detail::keyword_noexcept},
+        {nullptr, detail::no_keyword},
+        {"operator", detail::keyword_operator},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {"class", detail::keyword_class},
+        {nullptr, detail::no_keyword},
+        {"const", detail::keyword_const},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {"template", detail::keyword_template},
+        {"constexpr", detail::keyword_constexpr},
+        {"override", detail::keyword_override},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {"decltype", detail::keyword_decltype},
+        {nullptr, detail::no_keyword},
+        {"define", detail::keyword_define},
+        {"default", detail::keyword_default},
+        {"static", detail::keyword_static},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {"auto", detail::keyword_auto},
+        {nullptr, detail::no_keyword},
+        {"delete", detail::keyword_delete},
+        {"mutable", detail::keyword_mutable},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {"extern", detail::keyword_extern},
+        {"include", detail::keyword_include},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {"virtual", detail::keyword_virtual},
+        {"inline", detail::keyword_inline},
+        {nullptr, detail::no_keyword},
+        {"thread_local", detail::keyword_thread_local},
+        {nullptr, detail::no_keyword},
+        {"volatile", detail::keyword_volatile},
+        {nullptr, detail::no_keyword},
+        {"explicit", detail::keyword_explicit},
+        {"typedef", detail::keyword_typedef},
+        {"typename", detail::keyword_typename},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {nullptr, detail::no_keyword},
+        {"final", detail::keyword_final}
+    };
+}
+
+detail::token_keyword detail::get_keyword(const char *spelling, std::size_t length) STANDARDESE_NOEXCEPT
+{
+    if (length < 4u)
+        return no_keyword;
+
+    auto& entry = keyword_table[keyword_hash(spelling, length)];
+    if (!entry.spelling || std::strncmp(entry.spelling, spelling, length) != 0 || entry.spelling[length])
+        return no_keyword;
+    return entry.keyword;
+}
+
+detail::token_punctuation detail::get_punctuation(const char *spelling, std::size_t length) STANDARDESE_NOEXCEPT
+{
+    if (length == 1u)
+        switch (spelling[0])
+        {
+            case '(':
+                return punctuation_paren_open;
+            case ')':
+                return punctuation_paren_close;
+            case '[':
+                return punctuation_bracket_open;
+            case ']':
+                return punctuation_bracket_close;
+            case '{':
+                return punctuation_brace_open;
+            case '}':
+                return punctuation_brace_close;
+            case '<':
+                return punctuation_angle_open;
+            case '>':
+                return punctuation_angle_close;
+            case ':':
+                return punctuation_colon;
+            case ';':
+                return punctuation_semicolon;
+            case '=':
+                return punctuation_equal;
+            case '&':
+                return punctuation_amp;
+            default:
+                return no_punctuation;
+        }
+    else if (length == 2u && spelling[0] == '>' && spelling[1] == '>')
+        return punctuation_shift_right;
+    else if (length == 2u && spelling[0] == '-' && spelling[1] == '>')
+        return punctuation_arrow;
+    else if (length == 2u && spelling[0] == '&' && spelling[1] == '&')
+        return punctuation_amp_amp;
+    else if (length == 3u && std::strncmp(spelling, "...", 3u) == 0)
+        return punctuation_ellipsis;
+    return no_punctuation;
+}
+
+detail::tokenizer::tokenizer(CXCursor cur)
+{
+    auto tu = clang_Cursor_getTranslationUnit(cur);
+    auto source = clang_getCursorExtent(cur);
+
+    CXToken *tokens;
+    unsigned no_tokens;
+    clang_tokenize(tu, source, &tokens, &no_tokens);
+
+    if (no_tokens == 0u)
+        return;
+
+    try
+    {
+        // don't use the last token, it doesn't really belong to cursor
+        init(tu, tokens, no_tokens - 1);
+    }
+    catch (...)
+    {
+        clang_disposeTokens(tu, tokens, no_tokens);
+        throw;
+    }
+    clang_disposeTokens(tu, tokens, no_tokens);
+}
+
+detail::tokenizer::tokenizer(CXTranslationUnit tu, CXToken *begin, CXToken *end)
+{
+    if (begin != end)
+        init(tu, begin, unsigned(end - begin));
+}
+
+void detail::tokenizer::init(CXTranslationUnit tu, CXToken *tokens, unsigned no_tokens)
+{
+    // final and override are identifiers, the rest are keywords
+    auto make_token = [&](const char *spelling, std::size_t length, CXTokenKind kind)
+    {
+        auto keyword = kind == CXToken_Keyword || kind == CXToken_Identifier ?
+                       get_keyword(spelling, length) : no_keyword;
+        auto punctuation = kind == CXToken_Punctuation ? get_punctuation(spelling, length) : no_punctuation;
+        return token(spelling, length, kind, keyword, punctuation);
+    };
+
+    // read the spellings directly from the source file
+    // this doesn't require an allocation for each token
+    auto from_source = [&](CXFile file)
+    {
+        auto mapped = get_source_file(file);
+        if (!mapped)
+            return false;
+
+        for (auto i = 0u; i != no_tokens; ++i)
+        {
+            auto extent = clang_getTokenExtent(tu, tokens[i]);
+
+            unsigned begin, end;
+            if (!get_source_offset(clang_getRangeStart(extent), file, begin)
+                || !get_source_offset(clang_getRangeEnd(extent), file, end)
+                || begin > end || end > mapped->size())
+                return false;
+
+            auto spelling = mapped->data() + begin;
+            auto length = end - begin;
+            auto kind = clang_getTokenKind(tokens[i]);
+            tokens_.push_back(make_token(spelling, length, kind));
+        }
+
+        source_ = mapped->share();
+        return true;
+    };
+
+    // fallback: get the spellings from libclang
+    auto from_libclang = [&]
+    {
+        std::vector<std::size_t> offsets;
+        offsets.reserve(no_tokens);
+        for (auto i = 0u; i != no_tokens; ++i)
+        {
+            string str(clang_getTokenSpelling(tu, tokens[i]));
+            auto length = std::strlen(str.get());
+
+            auto kind = clang_getTokenKind(tokens[i]);
+            tokens_.push_back(make_token(str.get(), length, kind));
+            offsets.push_back(spellings_.size());
+            spellings_.append(str.get(), length);
+        }
+
+        // set spellings after the buffer is complete
+        for (std::size_t i = 0u; i != tokens_.size(); ++i)
+            tokens_[i].spelling_ = spellings_.data() + offsets[i];
+    };
+
+    // brackets have the depth outside of them
+    auto set_depth = [&]
+    {
+        auto depth = 0u;
+        for (auto& t : tokens_)
+        {
+            auto p = t.punctuation_;
+            if ((p == punctuation_paren_close || p == punctuation_bracket_close || p == punctuation_brace_close)
+                && depth != 0u)
+                --depth;
+            t.depth_ = depth;
+            if (p == punctuation_paren_open || p == punctuation_bracket_open || p == punctuation_brace_open)
+                ++depth;
+        }
+    };
+
+    tokens_.reserve(no_tokens);
+    if (no_tokens == 0u)
+        return;
+
+    CXFile file;
+    clang_getSpellingLocation(clang_getTokenLocation(tu, tokens[0]), &file, nullptr, nullptr, nullptr);
+    if (!file || !from_source(file))
+    {
+        tokens_.clear();
+        from_libclang();
+    }
+    set_depth();
+}
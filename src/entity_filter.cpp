@@ -0,0 +1,197 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/entity_filter.hpp>
+
+#include <standardese/detail/parse_utils.hpp>
+#include <standardese/cpp_template.hpp>
+#include <standardese/string.hpp>
+
+using namespace standardese;
+
+namespace
+{
+    // returns the type of the entity the cursor is parsed into
+    // or false if it isn't parsed as an entity of its own
+    // specialization is the type if the entity turns out to be a full specialization
+    // or file_t if it cannot be one, checking that requires tokenizing, so it is left to the caller
+    bool get_entity_type(cpp_cursor cur, cpp_entity::type &t, cpp_entity::type &specialization)
+    {
+        specialization = cpp_entity::file_t;
+        switch (clang_getCursorKind(cur))
+        {
+            case CXCursor_InclusionDirective:
+                t = cpp_entity::inclusion_directive_t;
+                return true;
+            case CXCursor_MacroDefinition:
+                t = cpp_entity::macro_definition_t;
+                return true;
+
+            case CXCursor_Namespace:
+                t = cpp_entity::namespace_t;
+                return true;
+            case CXCursor_NamespaceAlias:
+                t = cpp_entity::namespace_alias_t;
+                return true;
+            case CXCursor_UsingDirective:
+                t = cpp_entity::using_directive_t;
+                return true;
+            case CXCursor_UsingDeclaration:
+                t = cpp_entity::using_declaration_t;
+                return true;
+
+            case CXCursor_TypedefDecl:
+            case CXCursor_TypeAliasDecl:
+                t = cpp_entity::type_alias_t;
+                return true;
+
+            case CXCursor_EnumDecl:
+                t = cpp_entity::enum_t;
+                return true;
+            case CXCursor_EnumConstantDecl:
+                t = cpp_entity::enum_value_t;
+                return true;
+
+            case CXCursor_VarDecl:
+                t = cpp_entity::variable_t;
+                return true;
+            case CXCursor_FieldDecl:
+                t = clang_Cursor_isBitField(cur) ? cpp_entity::bitfield_t : cpp_entity::member_variable_t;
+                return true;
+
+            case CXCursor_FunctionDecl:
+                t = cpp_entity::function_t;
+                specialization = cpp_entity::function_template_specialization_t;
+                return true;
+            case CXCursor_CXXMethod:
+                t = cpp_entity::member_function_t;
+                specialization = cpp_entity::function_template_specialization_t;
+                return true;
+            case CXCursor_ConversionFunction:
+                t = cpp_entity::conversion_op_t;
+                specialization = cpp_entity::function_template_specialization_t;
+                return true;
+            case CXCursor_Constructor:
+                t = cpp_entity::constructor_t;
+                specialization = cpp_entity::function_template_specialization_t;
+                return true;
+            case CXCursor_Destructor:
+                t = cpp_entity::destructor_t;
+                return true;
+            case CXCursor_FunctionTemplate:
+                t = cpp_entity::function_template_t;
+                return true;
+
+            case CXCursor_ClassDecl:
+            case CXCursor_StructDecl:
+            case CXCursor_UnionDecl:
+                t = cpp_entity::class_t;
+                specialization = cpp_entity::class_template_full_specialization_t;
+                return true;
+            case CXCursor_ClassTemplate:
+                t = cpp_entity::class_template_t;
+                return true;
+            case CXCursor_ClassTemplatePartialSpecialization:
+                t = cpp_entity::class_template_partial_specialization_t;
+                return true;
+            case CXCursor_CXXBaseSpecifier:
+                t = cpp_entity::base_class_t;
+                return true;
+            case CXCursor_CXXAccessSpecifier:
+                t = cpp_entity::access_specifier_t;
+                return true;
+
+            default:
+                break;
+        }
+
+        return false;
+    }
+
+    // whether the entity is added to a file or namespace
+    bool is_namespace_scope(cpp_cursor cur, cpp_entity::type t)
+    {
+        if (t == cpp_entity::inclusion_directive_t || t == cpp_entity::macro_definition_t)
+            return true;
+
+        auto kind = clang_getCursorKind(clang_getCursorLexicalParent(cur));
+        return kind == CXCursor_Namespace || kind == CXCursor_TranslationUnit
+            || kind == CXCursor_LinkageSpec;
+    }
+
+    bool has_comment(cpp_cursor cur)
+    {
+        return !clang_Range_isNull(clang_Cursor_getCommentRange(cur));
+    }
+
+    // whether the member has a lower access than the given one
+    bool is_less_accessible(cpp_cursor cur, cpp_entity::type t, cpp_access_specifier_t access)
+    {
+        if (t == cpp_entity::access_specifier_t || t == cpp_entity::base_class_t)
+            return false;
+
+        switch (clang_getCXXAccessSpecifier(cur))
+        {
+            case CX_CXXPrivate:
+                return access != cpp_private;
+            case CX_CXXProtected:
+                return access == cpp_public;
+            default:
+                // public or not a member
+                break;
+        }
+
+        return false;
+    }
+}
+
+bool entity_filter::is_excluded(cpp_cursor cur) const
+{
+    if (namespaces_.empty() && types_ == 0u && access_ == cpp_private && !documented_only_)
+        // nothing is excluded
+        return false;
+
+    cpp_entity::type t, specialization;
+    if (!get_entity_type(cur, t, specialization))
+        return false;
+
+    if (types_ != 0u)
+    {
+        if (t == cpp_entity::enum_value_t)
+        {
+            if (is_blacklisted(cpp_entity::enum_value_t)
+                || is_blacklisted(cpp_entity::signed_enum_value_t)
+                || is_blacklisted(cpp_entity::unsigned_enum_value_t))
+                return true;
+        }
+        else if (specialization != cpp_entity::file_t
+                 && is_blacklisted(t) != is_blacklisted(specialization))
+        {
+            // only tokenize if it makes a difference
+            if (is_blacklisted(is_full_specialization(cur) ? specialization : t))
+                return true;
+        }
+        else if (is_blacklisted(t))
+            return true;
+    }
+
+    if (t == cpp_entity::namespace_t)
+    {
+        if (namespaces_.empty())
+            return false;
+
+        string spelling(clang_getCursorSpelling(cur));
+        auto scope = detail::parse_scope(cur);
+        auto full_name = scope.empty() ? std::string(spelling.get()) : scope + "::" + spelling.get();
+        for (auto& name : namespaces_)
+            if (name == spelling.get() || name == full_name)
+                return true;
+        return false;
+    }
+
+    if (access_ != cpp_private && is_less_accessible(cur, t, access_))
+        return !has_comment(cur);
+
+    return documented_only_ && is_namespace_scope(cur, t) && !has_comment(cur);
+}
@@ -4,17 +4,59 @@
 
 #include <standardese/generator.hpp>
 
+#include <standardese/ast_snapshot.hpp>
 #include <standardese/comment.hpp>
-#include <standardese/cpp_class.hpp>
-#include <standardese/cpp_enum.hpp>
-#include <standardese/cpp_namespace.hpp>
-#include <standardese/cpp_template.hpp>
 #include <standardese/synopsis.hpp>
 
 using namespace standardese;
 
 namespace
 {
+    void write_heading(output_base &output, unsigned level, cpp_entity::type t, const std::string &name)
+    {
+        auto type = get_entity_type_spelling(t);
+
+        output_base::heading_writer(output, level) << char(std::toupper(type[0])) << &type[1] << ' '
+            << output_base::style::code_span << name << output_base::style::code_span;
+    }
+
+    void write_comment(output_base &output, const cpp_name &unique_name, const cpp_raw_comment &raw_comment)
+    {
+        auto comment = comment::parser(unique_name.c_str(), raw_comment).finish();
+
+        auto last_type = section_type::brief;
+        output_base::paragraph_writer writer(output);
+        for (auto& sec : comment.get_sections())
+        {
+            if (last_type != sec.type)
+            {
+                writer.start_new();
+                if (!sec.name.empty())
+                    output.write_section_heading(sec.name);
+            }
+
+            writer << sec.body << newl;
+            last_type = sec.type;
+        }
+    }
+
+    // only uses the data stored in the snapshot
+    void generate_doc_entry(output_base &output, unsigned level,
+                            const ast_snapshot &snapshot, ast_snapshot::index i)
+    {
+        write_heading(output, level, snapshot.get_entity_type(i), snapshot.get_name(i).str());
+
+        {
+            output_base::code_block_writer w(output);
+            w << snapshot.get_synopsis(i).str();
+        }
+
+        auto scope = snapshot.get_scope(i);
+        auto name = snapshot.get_name(i);
+        write_comment(output, scope.empty() ? name.str() : scope.str() + "::" + name.str(),
+                      snapshot.get_comment(i));
+    }
+
     bool is_blacklisted(cpp_entity::type t)
     {
         return t == cpp_entity::inclusion_directive_t
@@ -24,40 +66,35 @@ namespace
             || t == cpp_entity::using_directive_t;
     }
 
-    void dispatch(output_base &output, unsigned level, const cpp_entity &e)
+    void dispatch(output_base &output, unsigned level, const ast_snapshot &snapshot, ast_snapshot::index i)
     {
-        if (is_blacklisted(e.get_entity_type()))
+        auto t = snapshot.get_entity_type(i);
+        if (is_blacklisted(t))
             return;
 
-        switch (e.get_entity_type())
+        switch (t)
         {
             case cpp_entity::namespace_t:
-                for (auto& child : static_cast<const cpp_namespace &>(e))
-                    dispatch(output, level, child);
+                for (auto child = snapshot.children_begin(i); child != snapshot.children_end(i); ++child)
+                    dispatch(output, level, snapshot, child);
                 break;
 
-            #define STANDARDESE_DETAIL_HANDLE(name, ...) \
-                case cpp_entity::name##_t: \
-                    if (e.get_comment().empty()) \
-                        break; \
-                    generate_doc_entity(output, level, e); \
-                    for (auto& child : static_cast<const cpp_##name &>(e)__VA_ARGS__) \
-                        dispatch(output, level + 1, child); \
-                    output.write_seperator(); \
+            case cpp_entity::class_t:
+            case cpp_entity::class_template_t:
+            case cpp_entity::class_template_full_specialization_t:
+            case cpp_entity::class_template_partial_specialization_t:
+            case cpp_entity::enum_t:
+                if (snapshot.get_comment(i).empty())
                     break;
-
-            STANDARDESE_DETAIL_HANDLE(class)
-            STANDARDESE_DETAIL_HANDLE(class_template, .get_class())
-            STANDARDESE_DETAIL_HANDLE(class_template_full_specialization, .get_class())
-            STANDARDESE_DETAIL_HANDLE(class_template_partial_specialization, .get_class())
-
-            STANDARDESE_DETAIL_HANDLE(enum)
-
-            #undef STANDARDESE_DETAIL_HANDLE
+                generate_doc_entry(output, level, snapshot, i);
+                for (auto child = snapshot.children_begin(i); child != snapshot.children_end(i); ++child)
+                    dispatch(output, level + 1, snapshot, child);
+                output.write_seperator();
+                break;
 
             default:
-                if (!e.get_comment().empty())
-                    generate_doc_entity(output, level, e);
+                if (!snapshot.get_comment(i).empty())
+                    generate_doc_entry(output, level, snapshot, i);
                 break;
         }
     }
@@ -138,35 +175,28 @@ const char* standardese::get_entity_type_spelling(cpp_entity::type t)
 
 void standardese::generate_doc_entity(output_base &output, unsigned level, const cpp_entity &e)
 {
-    auto type = get_entity_type_spelling(e.get_entity_type());
-
-    output_base::heading_writer(output, level) << char(std::toupper(type[0])) << &type[1] << ' '
-        << output_base::style::code_span << e.get_name() << output_base::style::code_span;
-
+    write_heading(output, level, e.get_entity_type(), e.get_name());
     write_synopsis(output, e);
+    write_comment(output, e.get_unique_name(), e.get_comment());
+}
 
-    auto comment = comment::parser(e).finish();
-
-    auto last_type = section_type::brief;
-    output_base::paragraph_writer writer(output);
-    for (auto& sec : comment.get_sections())
-    {
-        if (last_type != sec.type)
-        {
-            writer.start_new();
-            if (!sec.name.empty())
-                output.write_section_heading(sec.name);
-        }
-
-        writer << sec.body << newl;
-        last_type = sec.type;
-    }
+void standardese::generate_doc_entity(output_base &output, unsigned level,
+                                      const ast_snapshot &snapshot, std::uint32_t i)
+{
+    generate_doc_entry(output, level, snapshot, i);
+    for (auto child = snapshot.children_begin(i); child != snapshot.children_end(i); ++child)
+        dispatch(output, level + 1, snapshot, child);
 }
 
 void standardese::generate_doc_file(output_base &output, const cpp_file &f)
 {
-    generate_doc_entity(output, 1, f);
+    generate_doc_file(output, ast_snapshot(f));
+}
+
+void standardese::generate_doc_file(output_base &output, const ast_snapshot &snapshot)
+{
+    generate_doc_entry(output, 1, snapshot, 0);
 
-    for (auto& e : f)
-        dispatch(output, 2, e);
+    for (auto child = snapshot.children_begin(0); child != snapshot.children_end(0); ++child)
+        dispatch(output, 2, snapshot, child);
 }
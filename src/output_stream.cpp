@@ -4,6 +4,11 @@
 
 #include <standardese/output_stream.hpp>
 
+#include <cstring>
+#include <stdexcept>
+
+#include <standardese/detail/mapped_file.hpp>
+
 using namespace standardese;
 
 output_stream_base::~output_stream_base() STANDARDESE_NOEXCEPT {}
@@ -41,4 +46,46 @@ void output_stream_base::do_indent()
             do_write_char(' ');
         last_ = ' ';
     }
-}
\ No newline at end of file
+}
+
+file_update_output::~file_update_output() STANDARDESE_NOEXCEPT
+{
+    try
+    {
+        if (!closed_)
+            close();
+    }
+    catch (...) {}
+}
+
+namespace
+{
+    bool has_contents(const std::string &file, const std::string &contents)
+    {
+        try
+        {
+            detail::mapped_file existing(file.c_str());
+            return existing.size() == contents.size()
+                && std::memcmp(existing.data(), contents.data(), contents.size()) == 0;
+        }
+        catch (std::runtime_error&)
+        {
+            // doesn't exist yet
+            return false;
+        }
+    }
+}
+
+bool file_update_output::close()
+{
+    closed_ = true;
+    if (has_contents(file_, buffer_))
+        return false;
+
+    std::ofstream out(file_, std::ios::binary);
+    out.write(buffer_.data(), std::streamsize(buffer_.size()));
+    out.close();
+    if (!out)
+        throw std::runtime_error("unable to write file '" + file_ + "'");
+    return true;
+}
@@ -4,12 +4,18 @@
 
 #include <standardese/parser.hpp>
 
+#include <algorithm>
+#include <map>
 #include <mutex>
 #include <set>
+#include <stdexcept>
+#include <unordered_set>
 #include <vector>
 
+#include <standardese/detail/mapped_file.hpp>
 #include <standardese/cpp_namespace.hpp>
 #include <standardese/cpp_type.hpp>
+#include <standardese/string.hpp>
 #include <standardese/translation_unit.hpp>
 
 using namespace standardese;
@@ -28,10 +34,28 @@ namespace
             return a->get_unique_name() < b->get_unique_name();
         }
     };
+
+    struct shared_string_hash
+    {
+        std::size_t operator()(const shared_string &str) const STANDARDESE_NOEXCEPT
+        {
+            // FNV-1a
+            std::size_t hash = 2166136261u;
+            for (auto c : str)
+            {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+    };
 }
 
 struct parser::impl
 {
+    std::mutex string_mutex;
+    std::unordered_set<shared_string, shared_string_hash> strings;
+
     std::mutex file_mutex;
     std::vector<cpp_ptr<cpp_file>> files;
 
@@ -41,22 +65,224 @@ struct parser::impl
 
     std::mutex type_mutex;
     std::set<cpp_type*, type_compare> types;
+
+    std::mutex source_mutex;
+    // an AST built from a replaced version keeps it alive through mapped_file::share()
+    std::map<std::string, std::shared_ptr<const detail::mapped_file>> sources;
+
+    // destroys the AST of the file and removes its entities from the registries
+    void remove_file(const char *path)
+    {
+        std::unique_lock<std::mutex> file_lock(file_mutex), ns_lock(ns_mutex), type_lock(type_mutex);
+
+        auto get_file = [](const cpp_entity &e)
+        {
+            auto cur = &e;
+            while (cur->get_parent())
+                cur = cur->get_parent();
+            return cur;
+        };
+
+        for (auto iter = files.begin(); iter != files.end();)
+        {
+            if ((*iter)->get_name() != path)
+            {
+                ++iter;
+                continue;
+            }
+            auto file = iter->get();
+
+            for (auto type = types.begin(); type != types.end();)
+                if (get_file(**type) == file)
+                    type = types.erase(type);
+                else
+                    ++type;
+
+            namespaces.erase(std::remove_if(namespaces.begin(), namespaces.end(),
+                                            [&](cpp_namespace *ns) {return get_file(*ns) == file;}),
+                             namespaces.end());
+            namespace_names.clear();
+            for (auto ns : namespaces)
+                namespace_names.insert(ns->get_unique_name());
+
+            iter = files.erase(iter);
+        }
+    }
+
+    // returns the read file if it is the version libclang parsed
+    std::shared_ptr<const detail::mapped_file> read_source(const char *path, std::time_t time)
+    {
+        std::unique_lock<std::mutex> lock(source_mutex);
+        auto& source = sources[path];
+        if (!source || source->is_modified())
+        {
+            try
+            {
+                source = std::make_shared<detail::mapped_file>(path);
+            }
+            catch (std::runtime_error&)
+            {
+                source = nullptr;
+            }
+        }
+
+        return source && source->get_time() == time ? source : nullptr;
+    }
 };
 
 parser::parser()
-: index_(clang_createIndex(1, 1)), pimpl_(new impl)
-{}
+: index_(clang_createIndex(1, 1)), pimpl_(new impl), preprocessor_(preprocessor_detailed), preamble_(false)
+{
+    // a crash while parsing is reported as error instead of terminating the program
+    clang_toggleCrashRecovery(1);
+}
 
 parser::~parser() STANDARDESE_NOEXCEPT {}
 
+namespace
+{
+    CXTranslationUnit parse_tu(CXIndex index, const char *path, CXUnsavedFile *unsaved, const char *language,
+                               const char *standard, const std::string &pch, unsigned flags)
+    {
+        std::vector<const char*> args = {"-x", language, standard, "-I", LIBCLANG_SYSTEM_INCLUDE_DIR};
+        if (!pch.empty())
+        {
+            args.push_back("-include-pch");
+            args.push_back(pch.c_str());
+        }
+
+        CXTranslationUnit tu;
+        auto error = clang_parseTranslationUnit2(index, path, args.data(), int(args.size()),
+                                                 unsaved, unsaved ? 1u : 0u, flags, &tu);
+        if (error == CXError_Crashed)
+            throw std::runtime_error(std::string("libclang crashed while parsing '") + path + "'");
+        else if (error != CXError_Success)
+            throw std::runtime_error(std::string("libclang was unable to parse '") + path + "'");
+        detail::validate(tu);
+        return tu;
+    }
+
+    unsigned get_flags(preprocessor_mode preprocessor, bool preamble)
+    {
+        unsigned flags = CXTranslationUnit_Incomplete;
+        if (preprocessor == preprocessor_detailed)
+            flags |= CXTranslationUnit_DetailedPreprocessingRecord;
+        if (preamble)
+            flags |= CXTranslationUnit_PrecompiledPreamble;
+        return flags;
+    }
+
+    // contents of a file in the working directory including all of the given files,
+    // so they are found relative to it or in the include paths
+    std::string make_umbrella(const std::vector<std::string> &paths)
+    {
+        std::string result;
+        for (auto& path : paths)
+            result += "#include \"" + path + "\"\n";
+        return result;
+    }
+}
+
 translation_unit parser::parse(const char *path, const char *standard) const
 {
-    const char* args[] = {"-x", "c++", standard, "-I", LIBCLANG_SYSTEM_INCLUDE_DIR};
+    translation_unit::tu_ptr tu(parse_tu(index_.get(), path, nullptr, "c++", standard, pch_,
+                                         get_flags(preprocessor_, preamble_)),
+                                translation_unit::deleter());
+
+    translation_unit result(*this, std::move(tu), path);
+    result.scan_preprocessor_ = preprocessor_ == preprocessor_scan;
+    // keep the contents of the file for the lifetime of the parser,
+    // the comments of the entities refer to it
+    result.source_ = pimpl_->read_source(path, clang_getFileTime(result.get_cxfile()));
+    return result;
+}
+
+std::vector<translation_unit> parser::parse(const std::vector<std::string> &paths, const char *standard) const
+{
+    std::vector<translation_unit> result;
+    if (paths.empty())
+        return result;
+
+    auto umbrella = make_umbrella(paths);
+    CXUnsavedFile unsaved{"standardese-umbrella.cpp", umbrella.c_str(), static_cast<unsigned long>(umbrella.size())};
+
+    translation_unit::tu_ptr tu(parse_tu(index_.get(), unsaved.Filename, &unsaved, "c++", standard, pch_,
+                                         get_flags(preprocessor_, preamble_)),
+                                translation_unit::deleter());
+
+    result.reserve(paths.size());
+    for (auto& path : paths)
+    {
+        result.push_back(translation_unit(*this, tu, path.c_str()));
+
+        auto& unit = result.back();
+        unit.batch_ = true;
+        unit.scan_preprocessor_ = preprocessor_ == preprocessor_scan;
+        unit.source_ = pimpl_->read_source(path.c_str(), clang_getFileTime(unit.get_cxfile()));
+    }
+    return result;
+}
+
+void parser::reparse(translation_unit &tu) const
+{
+    if (tu.batch_)
+        throw std::invalid_argument(std::string("unable to reparse '") + tu.get_path() + "', it is part of a batch");
+
+    pimpl_->remove_file(tu.get_path());
+
+    auto error = clang_reparseTranslationUnit(tu.tu_.get(), 0u, nullptr, clang_defaultReparseOptions(tu.tu_.get()));
+    if (error == CXError_Crashed)
+        throw std::runtime_error(std::string("libclang crashed while parsing '") + tu.get_path() + "'");
+    else if (error != CXError_Success)
+        throw std::runtime_error(std::string("libclang was unable to parse '") + tu.get_path() + "'");
+
+    tu.source_ = pimpl_->read_source(tu.get_path(), clang_getFileTime(tu.get_cxfile()));
+}
+
+void parser::build_pch(const std::vector<std::string> &headers, const char *standard, const char *path) const
+{
+    auto umbrella = make_umbrella(headers);
+    CXUnsavedFile unsaved{"standardese-pch.hpp", umbrella.c_str(), static_cast<unsigned long>(umbrella.size())};
+
+    // the precompiled header must not include another one
+    translation_unit::tu_ptr tu(parse_tu(index_.get(), unsaved.Filename, &unsaved, "c++-header", standard, "",
+                                         get_flags(preprocessor_, false) | CXTranslationUnit_ForSerialization),
+                                translation_unit::deleter());
+
+    auto error = [&](const std::string &msg)
+    {
+        return std::runtime_error(std::string("unable to build precompiled header '") + path + "'" + msg);
+    };
+
+    // a header with errors would be missing declarations in every file using it
+    for (auto i = 0u; i != clang_getNumDiagnostics(tu.get()); ++i)
+    {
+        auto diag = clang_getDiagnostic(tu.get(), i);
+        auto severity = clang_getDiagnosticSeverity(diag);
+        string spelling(clang_getDiagnosticSpelling(diag));
+        clang_disposeDiagnostic(diag);
+
+        if (severity >= CXDiagnostic_Error)
+            throw error(std::string(": ") + spelling.get());
+    }
+
+    if (clang_saveTranslationUnit(tu.get(), path, clang_defaultSaveOptions(tu.get())) != CXSaveError_None)
+        throw error("");
+}
+
+shared_string parser::intern(const std::string &str) const
+{
+    if (str.empty())
+        return {};
 
-    auto tu = clang_parseTranslationUnit(index_.get(), path, args, sizeof(args) / sizeof(const char*), nullptr, 0,
-                                         CXTranslationUnit_Incomplete | CXTranslationUnit_DetailedPreprocessingRecord);
+    // lookup through a view so that nothing is allocated for known strings
+    shared_string view(nullptr, str.data(), str.size());
 
-    return translation_unit(*this, tu, path);
+    std::unique_lock<std::mutex> lock(pimpl_->string_mutex);
+    auto iter = pimpl_->strings.find(view);
+    if (iter == pimpl_->strings.end())
+        iter = pimpl_->strings.insert(shared_string(str)).first;
+    return *iter;
 }
 
 void parser::register_file(cpp_ptr<cpp_file> file) const
@@ -4,9 +4,13 @@
 
 #include <standardese/translation_unit.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 
+#include <standardese/detail/preprocessor_scan.hpp>
+#include <standardese/detail/source_file.hpp>
 #include <standardese/cpp_class.hpp>
 #include <standardese/cpp_cursor.hpp>
 #include <standardese/cpp_enum.hpp>
@@ -22,11 +26,11 @@
 using namespace standardese;
 
 cpp_file::cpp_file(const char *name)
-: cpp_entity(file_t, "", name, "")
+: cpp_entity(file_t, "", name, ""), cpp_entity_container(this)
 {}
 
-translation_unit::translation_unit(const parser &par, CXTranslationUnit tu, const char *path)
-: tu_(tu), path_(path), parser_(&par)
+translation_unit::translation_unit(const parser &par, tu_ptr tu, const char *path)
+: tu_(std::move(tu)), path_(path), parser_(&par), scan_preprocessor_(false), batch_(false)
 {}
 
 class translation_unit::scope_stack
@@ -34,7 +38,8 @@ class translation_unit::scope_stack
 public:
     // give it the file
     // this is always the first element and will never be erased
-    scope_stack(cpp_file *f, CXCursor parent)
+    scope_stack(const parser &par, cpp_file *f)
+    : next_preprocessor_(0u), parser_(&par)
     {
         struct cpp_file_parser : cpp_entity_parser
         {
@@ -54,22 +59,29 @@ public:
             }
         };
 
-        stack_.emplace_back(cpp_ptr<cpp_entity_parser>(new cpp_file_parser{f}), "", parent);
+        stack_.emplace_back(cpp_ptr<cpp_entity_parser>(new cpp_file_parser{f}), shared_string());
     }
 
-    const cpp_name& get_scope_name() const STANDARDESE_NOEXCEPT
+    // all entities of a container share the same interned scope name
+    const shared_string& get_scope_name() const STANDARDESE_NOEXCEPT
     {
         return stack_.back().scope_name;
     }
 
+    std::size_t size() const STANDARDESE_NOEXCEPT
+    {
+        return stack_.size();
+    }
+
     // pushes a new container
-    void push_container(cpp_ptr<cpp_entity_parser> parser, CXCursor parent)
+    void push_container(cpp_ptr<cpp_entity_parser> parser)
     {
-        auto scope_name = stack_.back().scope_name;
+        auto scope_name = stack_.back().scope_name.str();
+        auto name = parser->scope_name();
         if (!scope_name.empty())
             scope_name += "::";
-        scope_name += parser->scope_name();
-        stack_.emplace_back(std::move(parser), scope_name, parent);
+        scope_name += name;
+        stack_.emplace_back(std::move(parser), parser_->intern(scope_name));
     }
 
     // adds a non-container entity to the current container
@@ -79,58 +91,260 @@ public:
         top.parser->add_entity(std::move(e));
     }
 
-    // pops a container if needed
-    // needs to be called in each visit
-    bool pop_if_needed(CXCursor parent, const parser &par)
+    // sets the scanned preprocessor entities, sorted by offset
+    void set_preprocessor_entities(std::vector<detail::preprocessor_entity> entities)
     {
-        for (auto iter = std::next(stack_.begin()); iter != stack_.end(); ++iter)
-        {
-            if (clang_equalCursors(iter->parent, parent))
-            {
-                auto dist = stack_.end() - iter;
-                for (auto i = 0; i != dist; ++i)
-                {
-                    auto e = stack_.back().parser->finish(par);
-                    stack_.pop_back();
-                    assert(!stack_.empty());
-                    stack_.back().parser->add_entity(std::move(e));
-                }
-
-                return true;
-            }
-        }
+        preprocessor_ = std::move(entities);
+        next_preprocessor_ = 0u;
+    }
+
+    // adds all scanned preprocessor entities before offset to the file
+    void add_preprocessor_entities(unsigned offset)
+    {
+        assert(stack_.size() == 1u);
+        for (; next_preprocessor_ != preprocessor_.size()
+               && preprocessor_[next_preprocessor_].offset < offset; ++next_preprocessor_)
+            add_entity(std::move(preprocessor_[next_preprocessor_].entity));
+    }
 
-        return false;
+    // finishes the current container and adds it to its parent
+    // called after all children of the container have been visited
+    void pop_container()
+    {
+        assert(stack_.size() > 1u);
+        auto e = stack_.back().parser->finish(*parser_);
+        stack_.pop_back();
+        stack_.back().parser->add_entity(std::move(e));
     }
 
 private:
     struct container
     {
         cpp_ptr<cpp_entity_parser> parser;
-        cpp_name scope_name;
-        CXCursor parent;
+        shared_string scope_name;
 
-        container(cpp_ptr<cpp_entity_parser> par, cpp_name scope_name, CXCursor parent)
-        : parser(std::move(par)), scope_name(std::move(scope_name)), parent(parent)
+        container(cpp_ptr<cpp_entity_parser> par, shared_string scope_name)
+        : parser(std::move(par)), scope_name(std::move(scope_name))
         {}
     };
 
     std::vector<container> stack_;
+    std::vector<detail::preprocessor_entity> preprocessor_;
+    std::size_t next_preprocessor_;
+    const parser *parser_;
 };
 
 cpp_file& translation_unit::build_ast() const
 {
     cpp_ptr<cpp_file> result(new cpp_file(get_path()));
 
-    scope_stack stack(result.get(), clang_getTranslationUnitCursor(tu_.get()));
-    visit([&](CXCursor cur, CXCursor parent) {return this->parse_visit(stack, cur, parent);});
-    stack.pop_if_needed(clang_getTranslationUnitCursor(tu_.get()), *parser_);
+    // the file was already read by the parser, no need to check it again
+    detail::source_file_scope source(get_cxfile(), source_);
+
+    scope_stack stack(*parser_, result.get());
+    if (scan_preprocessor_)
+        scan_preprocessor(stack);
+    parse_children(stack, clang_getTranslationUnitCursor(tu_.get()), get_cxfile());
+    if (scan_preprocessor_)
+        stack.add_preprocessor_entities(unsigned(-1));
 
     auto& ref = *result;
     parser_->register_file(std::move(result));
     return ref;
 }
 
+namespace
+{
+    // keeps the sources of all files of a batch available
+    class source_file_scopes
+    {
+    public:
+        source_file_scopes() = default;
+
+        source_file_scopes(const source_file_scopes&) = delete;
+        source_file_scopes& operator=(const source_file_scopes&) = delete;
+
+        // scopes must be destroyed in reverse order
+        ~source_file_scopes() STANDARDESE_NOEXCEPT
+        {
+            while (!scopes_.empty())
+                scopes_.pop_back();
+        }
+
+        void add(CXFile file, std::shared_ptr<const detail::mapped_file> source)
+        {
+            scopes_.emplace_back(new detail::source_file_scope(file, std::move(source)));
+        }
+
+    private:
+        std::vector<std::unique_ptr<detail::source_file_scope>> scopes_;
+    };
+
+    // whether the location is in the first inclusion of the file,
+    // for an offset libclang returns the location in the first inclusion
+    bool is_first_inclusion(CXTranslationUnit tu, CXFile file, CXSourceLocation location)
+    {
+        CXFile location_file;
+        unsigned offset;
+        clang_getExpansionLocation(location, &location_file, nullptr, nullptr, &offset);
+        return location_file && clang_File_isEqual(location_file, file)
+            && clang_equalLocations(location, clang_getLocationForOffset(tu, file, offset));
+    }
+}
+
+std::vector<cpp_file*> translation_unit::build_ast(const std::vector<translation_unit> &batch)
+{
+    if (batch.empty())
+        return {};
+
+    struct unit_data
+    {
+        const translation_unit *unit;
+        CXFile file;
+        cpp_ptr<cpp_file> result;
+        std::unique_ptr<scope_stack> stack;
+        unsigned last_offset;
+        bool first_inclusion;
+    };
+    std::vector<unit_data> units;
+    units.reserve(batch.size());
+
+    source_file_scopes sources;
+    for (auto& unit : batch)
+    {
+        if (unit.tu_ != batch.front().tu_)
+            throw std::invalid_argument("translation units of a batch must share the libclang translation unit");
+
+        units.push_back(unit_data{&unit, unit.get_cxfile(), cpp_ptr<cpp_file>(new cpp_file(unit.get_path())),
+                                  nullptr, 0u, true});
+        units.back().stack.reset(new scope_stack(*unit.parser_, units.back().result.get()));
+        sources.add(units.back().file, unit.source_);
+        if (unit.scan_preprocessor_)
+            unit.scan_preprocessor(*units.back().stack);
+    }
+
+    // visit the shared translation unit once,
+    // each entity is parsed into the file it is located in
+    struct data_t
+    {
+        std::vector<unit_data> *units;
+        std::size_t last;
+    } data{&units, 0u};
+
+    auto visitor_impl = [](CXCursor cursor, CXCursor, CXClientData client_data) -> CXChildVisitResult
+    {
+        auto data = static_cast<data_t*>(client_data);
+
+        auto location = clang_getCursorLocation(cursor);
+        CXFile file;
+        unsigned offset;
+        clang_getExpansionLocation(location, &file, nullptr, nullptr, &offset);
+        if (!file)
+            return CXChildVisit_Continue;
+
+        // consecutive entities are almost always in the same file
+        auto& units = *data->units;
+        if (!clang_File_isEqual(file, units[data->last].file))
+        {
+            auto iter = std::find_if(units.begin(), units.end(),
+                                     [&](const unit_data &unit)
+                                     {
+                                         return clang_File_isEqual(file, unit.file);
+                                     });
+            if (iter == units.end())
+                return CXChildVisit_Continue;
+            data->last = std::size_t(iter - units.begin());
+        }
+
+        // a file without include guard can be included multiple times,
+        // only parse its first inclusion
+        // an entity is in it if its location is, or the end of its extent if it is expanded from a macro,
+        // an entity declared in a macro argument has neither,
+        // it is in the inclusion of the entity before it unless the offset goes back
+        auto& unit = units[data->last];
+        auto tu = clang_Cursor_getTranslationUnit(cursor);
+        if (is_first_inclusion(tu, unit.file, location)
+            || is_first_inclusion(tu, unit.file, clang_getRangeEnd(clang_getCursorExtent(cursor))))
+            unit.first_inclusion = true;
+        else if (offset < unit.last_offset)
+            unit.first_inclusion = false;
+        unit.last_offset = offset;
+        if (!unit.first_inclusion)
+            return CXChildVisit_Continue;
+
+        unit.unit->parse_entity(*unit.stack, cursor, unit.file);
+        return CXChildVisit_Continue;
+    };
+    clang_visitChildren(clang_getTranslationUnitCursor(batch.front().tu_.get()), visitor_impl, &data);
+
+    std::vector<cpp_file*> result;
+    result.reserve(units.size());
+    for (auto& unit : units)
+    {
+        if (unit.unit->scan_preprocessor_)
+            unit.stack->add_preprocessor_entities(unsigned(-1));
+
+        result.push_back(unit.result.get());
+        unit.unit->parser_->register_file(std::move(unit.result));
+    }
+    return result;
+}
+
+std::vector<std::string> translation_unit::get_includes() const
+{
+    struct data_t
+    {
+        CXFile file;
+        bool batch;
+        std::vector<std::string> includes;
+    } data{get_cxfile(), batch_, {}};
+
+    auto visitor = [](CXFile included, CXSourceLocation *stack, unsigned size, CXClientData client_data)
+    {
+        auto data = static_cast<data_t*>(client_data);
+        if (size == 0u || clang_File_isEqual(included, data->file))
+            // main file or the file itself
+            return;
+        else if (data->batch)
+        {
+            string name(clang_getFileName(included));
+            data->includes.push_back(name.get());
+            return;
+        }
+
+        for (auto i = 0u; i != size; ++i)
+        {
+            CXFile file;
+            clang_getSpellingLocation(stack[i], &file, nullptr, nullptr, nullptr);
+            if (file && clang_File_isEqual(file, data->file))
+            {
+                string name(clang_getFileName(included));
+                data->includes.push_back(name.get());
+                break;
+            }
+        }
+    };
+    clang_getInclusions(tu_.get(), visitor, &data);
+
+    std::sort(data.includes.begin(), data.includes.end());
+    data.includes.erase(std::unique(data.includes.begin(), data.includes.end()), data.includes.end());
+    return data.includes;
+}
+
+std::size_t translation_unit::get_memory_usage() const
+{
+    auto usage = clang_getCXTUResourceUsage(tu_.get());
+
+    std::size_t result = 0u;
+    for (auto i = 0u; i != usage.numEntries; ++i)
+        if (usage.entries[i].kind >= CXTUResourceUsage_MEMORY_IN_BYTES_BEGIN
+            && usage.entries[i].kind <= CXTUResourceUsage_MEMORY_IN_BYTES_END)
+            result += usage.entries[i].amount;
+
+    clang_disposeCXTUResourceUsage(usage);
+    return result;
+}
+
 CXFile translation_unit::get_cxfile() const STANDARDESE_NOEXCEPT
 {
     auto file = clang_getFile(tu_.get(), get_path());
@@ -143,17 +357,84 @@ void translation_unit::deleter::operator()(CXTranslationUnit tu) const STANDARDE
     clang_disposeTranslationUnit(tu);
 }
 
-CXChildVisitResult translation_unit::parse_visit(scope_stack &stack, CXCursor cur, CXCursor parent) const
+void translation_unit::scan_preprocessor(scope_stack &stack) const
+{
+    if (!source_)
+        return;
+
+    // the scanned entities don't have cursors or comments,
+    // so only filter by type
+    auto& filter = parser_->get_filter();
+    if (filter.is_documented_only())
+        return;
+
+    auto entities = detail::scan_preprocessor(tu_.get(), get_cxfile(), *source_);
+    entities.erase(std::remove_if(entities.begin(), entities.end(),
+                                  [&](const detail::preprocessor_entity &e)
+                                  {
+                                      return filter.is_blacklisted(e.entity->get_entity_type());
+                                  }),
+                   entities.end());
+    stack.set_preprocessor_entities(std::move(entities));
+}
+
+void translation_unit::parse_entity(scope_stack &stack, CXCursor cur, CXFile file) const
+{
+    auto depth = stack.size();
+    if (depth == 1u && scan_preprocessor_)
+    {
+        // add the scanned preprocessor entities in front of the first entity after them
+        unsigned offset;
+        if (detail::get_source_offset(clang_getRangeStart(clang_getCursorExtent(cur)), file, offset))
+            stack.add_preprocessor_entities(offset);
+    }
+
+    if (parse_visit(stack, cur) == CXChildVisit_Recurse)
+        parse_children(stack, cur, file);
+    if (stack.size() != depth)
+        stack.pop_container();
+}
+
+void translation_unit::parse_children(scope_stack &stack, CXCursor parent, CXFile file) const
 {
-    stack.pop_if_needed(parent, *parser_);
+    // visit the children of each entity in its own call,
+    // so a container is finished as soon as its children are done
+    struct data_t
+    {
+        const translation_unit *self;
+        scope_stack *stack;
+        CXFile file;
+    } data{this, &stack, file};
+
+    auto visitor_impl = [](CXCursor cursor, CXCursor, CXClientData client_data) -> CXChildVisitResult
+    {
+        auto data = static_cast<data_t*>(client_data);
+
+        auto location = clang_getCursorLocation(cursor);
+        CXFile file;
+        clang_getExpansionLocation(location, &file, nullptr, nullptr, nullptr);
+        if (!file || !clang_File_isEqual(file, data->file))
+            return CXChildVisit_Continue;
+
+        data->self->parse_entity(*data->stack, cursor, data->file);
+        return CXChildVisit_Continue;
+    };
+
+    clang_visitChildren(parent, visitor_impl, &data);
+}
 
-    auto scope = stack.get_scope_name();
+CXChildVisitResult translation_unit::parse_visit(scope_stack &stack, CXCursor cur) const
+{
+    auto& scope = stack.get_scope_name();
 
     auto kind = clang_getCursorKind(cur);
     if (kind != CXCursor_CXXBaseSpecifier
         && (clang_isReference(kind) || clang_isExpression(kind)))
         // ignore those
         return CXChildVisit_Continue;
+    else if (parser_->get_filter().is_excluded(cur))
+        // skip it together with all children
+        return CXChildVisit_Continue;
 
     switch (kind)
     {
@@ -165,7 +446,7 @@ CXChildVisitResult translation_unit::parse_visit(scope_stack &stack, CXCursor cu
             return CXChildVisit_Continue;
 
         case CXCursor_Namespace:
-            stack.push_container(detail::make_ptr<cpp_namespace::parser>(scope, cur), parent);
+            stack.push_container(detail::make_ptr<cpp_namespace::parser>(scope, cur));
             return CXChildVisit_Recurse;
         case CXCursor_NamespaceAlias:
             stack.add_entity(cpp_namespace_alias::parse(scope, cur));
@@ -183,7 +464,7 @@ CXChildVisitResult translation_unit::parse_visit(scope_stack &stack, CXCursor cu
             return CXChildVisit_Continue;
 
         case CXCursor_EnumDecl:
-            stack.push_container(detail::make_ptr<cpp_enum::parser>(scope, cur), parent);
+            stack.push_container(detail::make_ptr<cpp_enum::parser>(scope, cur));
             return CXChildVisit_Recurse;
         case CXCursor_EnumConstantDecl:
             stack.add_entity(cpp_enum_value::parse(scope, cur));
@@ -233,16 +514,16 @@ CXChildVisitResult translation_unit::parse_visit(scope_stack &stack, CXCursor cu
         case CXCursor_UnionDecl:
             if (is_full_specialization(cur))
                 stack.push_container(detail::make_ptr<cpp_class_template_full_specialization::parser>
-                                                       (scope, cur), parent);
+                                                       (scope, cur));
             else
-                stack.push_container(detail::make_ptr<cpp_class::parser>(scope, cur), parent);
+                stack.push_container(detail::make_ptr<cpp_class::parser>(scope, cur));
             return CXChildVisit_Recurse;
         case CXCursor_ClassTemplate:
-            stack.push_container(detail::make_ptr<cpp_class_template::parser>(scope, cur), parent);
+            stack.push_container(detail::make_ptr<cpp_class_template::parser>(scope, cur));
             return CXChildVisit_Recurse;
         case CXCursor_ClassTemplatePartialSpecialization:
             stack.push_container(detail::make_ptr<cpp_class_template_partial_specialization::parser>
-                                                    (scope, cur), parent);
+                                                    (scope, cur));
             return CXChildVisit_Recurse;
         case CXCursor_CXXBaseSpecifier:
             stack.add_entity(cpp_base_class::parse(scope, cur));
@@ -0,0 +1,167 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/ast_snapshot.hpp>
+
+#include <sstream>
+
+#include <catch.hpp>
+#include <standardese/generator.hpp>
+#include <standardese/output_stream.hpp>
+
+#include "test_parser.hpp"
+
+using namespace standardese;
+
+TEST_CASE("ast_snapshot", "[cpp]")
+{
+    parser p;
+
+    auto code = R"(
+        namespace ns
+        {
+            /// a
+            struct a
+            {
+                int x;
+                void f(int param);
+            };
+
+            template <typename T>
+            struct b
+            {
+                T y;
+            };
+        }
+
+        enum e
+        {
+            e_0,
+            e_1
+        };
+    )";
+
+    auto tu = parse(p, "ast_snapshot", code);
+    auto& file = tu.build_ast();
+
+    ast_snapshot snapshot(file);
+    REQUIRE(snapshot.size() == 10u);
+
+    REQUIRE(&snapshot.get_entity(0) == &file);
+    REQUIRE(snapshot.get_entity_type(0) == cpp_entity::file_t);
+    REQUIRE(snapshot.get_parent(0) == ast_snapshot::no_parent);
+    REQUIRE(snapshot.children_begin(0) == 1u);
+    REQUIRE(snapshot.children_end(0) == 3u);
+
+    for (ast_snapshot::index i = 1u; i != snapshot.size(); ++i)
+    {
+        auto& e = snapshot.get_entity(i);
+        REQUIRE(snapshot.get_entity_type(i) == e.get_entity_type());
+        REQUIRE(snapshot.get_name(i) == e.get_name());
+        REQUIRE(snapshot.get_scope(i) == e.get_scope());
+        REQUIRE(snapshot.get_comment(i) == e.get_comment());
+
+        auto parent = snapshot.get_parent(i);
+        REQUIRE(parent < i);
+        REQUIRE(snapshot.children_begin(parent) <= i);
+        REQUIRE(i < snapshot.children_end(parent));
+    }
+
+    // ns, e, a, b, e_0, e_1, x, f, y
+    REQUIRE(snapshot.get_name(1) == "ns");
+    REQUIRE(snapshot.get_name(2) == "e");
+    REQUIRE(snapshot.get_entity_type(4) == cpp_entity::class_template_t);
+    REQUIRE(snapshot.get_comment(3) == "/// a");
+    REQUIRE(snapshot.get_scope(9) == "ns::b");
+    REQUIRE(snapshot.get_parent(9) == 4u);
+    REQUIRE(snapshot.children_begin(7) == snapshot.children_end(7));
+
+    // members of a share the scope storage
+    REQUIRE(snapshot.get_scope(7).data() == snapshot.get_scope(8).data());
+
+    REQUIRE(find_entity(file, "ns::a") == &snapshot.get_entity(3));
+    REQUIRE(find_entity(file, "ns::a::f") == &snapshot.get_entity(8));
+    REQUIRE(find_entity(file, "ns::a::") == nullptr);
+    REQUIRE(find_entity(file, "a") == nullptr);
+
+    ast_snapshot a(snapshot.get_entity(3));
+    REQUIRE(a.size() == 3u);
+    REQUIRE(&a.get_entity(0) == &snapshot.get_entity(3));
+    REQUIRE(a.get_parent(0) == ast_snapshot::no_parent);
+    REQUIRE(a.get_name(2) == "f");
+    REQUIRE(a.get_synopsis(0) == snapshot.get_synopsis(3));
+}
+
+TEST_CASE("ast_snapshot serialization", "[cpp]")
+{
+    parser p;
+
+    auto code = R"(
+        /// a
+        struct a
+        {
+            /// b
+            void b(int c);
+        };
+
+        /// d
+        using d = int;
+    )";
+
+    auto tu = parse(p, "ast_snapshot_serialization", code);
+    ast_snapshot snapshot(tu.build_ast());
+
+    {
+        std::ofstream out("ast_snapshot_serialization.snapshot", std::ios::binary);
+        snapshot.save(out);
+    }
+    auto loaded = ast_snapshot::load("ast_snapshot_serialization.snapshot");
+
+    REQUIRE(!loaded.has_entities());
+    REQUIRE(loaded.size() == snapshot.size());
+    for (ast_snapshot::index i = 0u; i != snapshot.size(); ++i)
+    {
+        REQUIRE(loaded.get_entity_type(i) == snapshot.get_entity_type(i));
+        REQUIRE(loaded.get_parent(i) == snapshot.get_parent(i));
+        REQUIRE(loaded.children_begin(i) == snapshot.children_begin(i));
+        REQUIRE(loaded.children_end(i) == snapshot.children_end(i));
+        REQUIRE(loaded.get_name(i) == snapshot.get_name(i));
+        REQUIRE(loaded.get_scope(i) == snapshot.get_scope(i));
+        REQUIRE(loaded.get_comment(i) == snapshot.get_comment(i));
+        REQUIRE(loaded.get_synopsis(i) == snapshot.get_synopsis(i));
+    }
+    REQUIRE(loaded.get_synopsis(1) == "struct a\n{\n    void b(int c);\n};");
+
+    auto generate = [](const ast_snapshot &s)
+    {
+        std::ostringstream str;
+        streambuf_output stream(str);
+        markdown_output out(stream);
+        generate_doc_file(out, s);
+        return str.str();
+    };
+    REQUIRE(generate(loaded) == generate(snapshot));
+
+    std::ostringstream entity;
+    {
+        streambuf_output stream(entity);
+        markdown_output out(stream);
+        generate_doc_entity(out, 1, loaded, 1);
+    }
+    REQUIRE(entity.str().find("a") != std::string::npos);
+    REQUIRE(entity.str().find("b(int c)") != std::string::npos);
+    REQUIRE(entity.str().find("using d") == std::string::npos);
+
+    // the same as the snapshot of the entity alone
+    std::ostringstream alone;
+    {
+        streambuf_output stream(alone);
+        markdown_output out(stream);
+        generate_doc_entity(out, 1, ast_snapshot(snapshot.get_entity(1)), 0);
+    }
+    REQUIRE(alone.str() == entity.str());
+
+    std::ofstream("ast_snapshot_serialization.invalid") << "not a snapshot";
+    REQUIRE_THROWS_AS(ast_snapshot::load("ast_snapshot_serialization.invalid"), std::runtime_error);
+}
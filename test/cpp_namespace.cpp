@@ -62,6 +62,7 @@ TEST_CASE("cpp_namespace", "[cpp]")
         auto i = 0u;
         for (auto& e : file)
         {
+            REQUIRE(e.get_parent() == &file);
             auto& ns = dynamic_cast<const cpp_namespace&>(e);
 
             auto name = "ns_" + std::to_string(i);
@@ -70,9 +71,14 @@ TEST_CASE("cpp_namespace", "[cpp]")
 
             if (i == 0u)
             {
+                // scope name is shared
+                REQUIRE(ns.begin()->get_scope() == "ns_0");
+                REQUIRE(ns.begin()->get_scope().data() == std::next(ns.begin())->get_scope().data());
+
                 auto j = 0u;
                 for (auto& e : ns)
                 {
+                    REQUIRE(e.get_parent() == &ns);
                     auto& ns = dynamic_cast<const cpp_namespace&>(e);
 
                     auto name = "ns_0_" + std::to_string(j);
@@ -96,6 +102,44 @@ TEST_CASE("cpp_namespace", "[cpp]")
         }
         REQUIRE(i == 2u);
     }
+    SECTION("deep nesting")
+    {
+        // namespaces and then classes, each followed by a sibling variable
+        const auto depth = 128u;
+        std::string code, unique_name;
+        for (auto i = 0u; i != depth; ++i)
+        {
+            auto name = (i < depth / 2 ? "ns_" : "c_") + std::to_string(i);
+            code += (i < depth / 2 ? "namespace " : "struct ") + name + " {\n";
+            unique_name += name + "::";
+        }
+        code += "int innermost;\n";
+        for (auto i = depth - 1; i != 0u; --i)
+            code += (i < depth / 2 ? "}\n" : "};\n") + std::string("int after_") + std::to_string(i) + ";\n";
+        code += "}\n";
+
+        auto tu = parse(p, "cpp_namespace__deep_nesting", code.c_str());
+        auto& file = tu.build_ast();
+
+        const cpp_entity *cur = &*file.begin();
+        REQUIRE(std::next(file.begin()) == file.end());
+        for (auto i = 1u; i != depth; ++i)
+        {
+            auto& container = dynamic_cast<const cpp_entity_container<cpp_entity>&>(*cur);
+            auto iter = container.begin();
+            REQUIRE(iter != container.end());
+
+            auto& sibling = *std::next(iter);
+            REQUIRE(sibling.get_name() == "after_" + std::to_string(i));
+            REQUIRE(sibling.get_parent() == cur);
+
+            cur = &*iter;
+        }
+
+        auto& innermost = *dynamic_cast<const cpp_entity_container<cpp_entity>&>(*cur).begin();
+        REQUIRE(innermost.get_name() == "innermost");
+        REQUIRE(innermost.get_unique_name() == unique_name + "innermost");
+    }
     SECTION("multiple tu")
     {
         auto code_a = R"(
@@ -127,6 +171,81 @@ TEST_CASE("cpp_namespace", "[cpp]")
                              });
         REQUIRE(names.empty());
     }
+    SECTION("batch")
+    {
+        std::ofstream("cpp_namespace__batch__a") << R"(
+            #include "cpp_namespace__batch__b"
+
+            namespace outer
+            {
+                void a();
+            }
+        )";
+        std::ofstream("cpp_namespace__batch__b") << R"(
+            namespace outer
+            {
+                void b();
+            }
+
+            namespace inner {}
+        )";
+
+        auto batch = p.parse({"cpp_namespace__batch__a", "cpp_namespace__batch__b"}, cpp_standard::cpp_14);
+        REQUIRE(batch.size() == 2u);
+
+        auto files = translation_unit::build_ast(batch);
+        REQUIRE(files.size() == 2u);
+
+        auto& a = *files[0];
+        REQUIRE(a.get_name() == "cpp_namespace__batch__a");
+        REQUIRE(std::distance(a.begin(), a.end()) == 2);
+
+        auto& outer_a = dynamic_cast<const cpp_namespace&>(*std::next(a.begin()));
+        REQUIRE(outer_a.get_name() == "outer");
+        REQUIRE(outer_a.begin()->get_name() == "a");
+        REQUIRE(std::next(outer_a.begin()) == outer_a.end());
+
+        auto& b = *files[1];
+        REQUIRE(b.get_name() == "cpp_namespace__batch__b");
+        REQUIRE(std::distance(b.begin(), b.end()) == 2);
+
+        auto& outer_b = dynamic_cast<const cpp_namespace&>(*b.begin());
+        REQUIRE(outer_b.begin()->get_name() == "b");
+        REQUIRE(std::next(b.begin())->get_name() == "inner");
+    }
+    SECTION("batch macro")
+    {
+        // no include guard, so it is included twice
+        std::ofstream("cpp_namespace__batch_macro__a") << R"(
+            #define CPP_NAMESPACE_BATCH_MACRO_PAIR(x) void x##_first(); void x##_second();
+
+            namespace pair
+            {
+                CPP_NAMESPACE_BATCH_MACRO_PAIR(a)
+            }
+
+            CPP_NAMESPACE_BATCH_MACRO_PAIR(b)
+        )";
+        std::ofstream("cpp_namespace__batch_macro__b") << R"(
+            #include "cpp_namespace__batch_macro__a"
+        )";
+
+        p.set_preprocessor_mode(preprocessor_none);
+        auto batch = p.parse({"cpp_namespace__batch_macro__b", "cpp_namespace__batch_macro__a"},
+                             cpp_standard::cpp_14);
+        auto files = translation_unit::build_ast(batch);
+        REQUIRE(files.size() == 2u);
+
+        auto& a = *files[1];
+        REQUIRE(std::distance(a.begin(), a.end()) == 3);
+
+        auto& ns = dynamic_cast<const cpp_namespace&>(*a.begin());
+        REQUIRE(ns.get_name() == "pair");
+        REQUIRE(std::distance(ns.begin(), ns.end()) == 2);
+
+        REQUIRE(std::next(a.begin())->get_name() == "b_first");
+        REQUIRE(std::next(a.begin(), 2)->get_name() == "b_second");
+    }
 }
 
 TEST_CASE("cpp_namespace_alias", "[cpp]")
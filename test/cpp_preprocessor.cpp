@@ -89,3 +89,59 @@ TEST_CASE("cpp_preprocessor", "[cpp]")
     });
     REQUIRE(count == 7u);
 }
+
+TEST_CASE("cpp_preprocessor_mode", "[cpp]")
+{
+    parser p;
+
+    auto code = R"(
+        #include <boost/config.hpp>
+
+        struct a {};
+
+        #include "cpp_variable"
+        #define B foo
+
+        namespace c
+        {
+            #define D(x, ...) \
+                __VA_ARGS__
+        }
+
+        #if 0
+        #define E
+        #endif
+    )";
+
+    SECTION("scan")
+    {
+        p.set_preprocessor_mode(preprocessor_scan);
+
+        auto tu = parse(p, "cpp_preprocessor_mode__scan", code);
+        auto& file = tu.build_ast();
+
+        std::string names;
+        for (auto& e : file)
+            names += e.get_name() + ' ';
+        REQUIRE(names == "boost/config.hpp a cpp_variable B c D E ");
+
+        auto& inc = dynamic_cast<const cpp_inclusion_directive&>(*file.begin());
+        REQUIRE(inc.get_kind() == cpp_inclusion_directive::system);
+
+        auto& macro = dynamic_cast<const cpp_macro_definition&>(*std::next(file.begin(), 5));
+        REQUIRE(macro.get_argument_string() == "(x, ...)");
+        REQUIRE(macro.get_replacement() == "__VA_ARGS__");
+    }
+    SECTION("none")
+    {
+        p.set_preprocessor_mode(preprocessor_none);
+
+        auto tu = parse(p, "cpp_preprocessor_mode__none", code);
+        auto& file = tu.build_ast();
+
+        std::string names;
+        for (auto& e : file)
+            names += e.get_name() + ' ';
+        REQUIRE(names == "a c ");
+    }
+}
@@ -562,6 +562,7 @@ TEST_CASE("cpp_class_template", "[cpp]")
         template <typename T>
         struct should_be_ignored;
 
+        /// c
         template <typename A>
         struct a
         {};
@@ -617,6 +618,10 @@ TEST_CASE("cpp_class_template", "[cpp]")
                 REQUIRE(c->get_name() == "a<A>");
                 REQUIRE(c->get_class().get_class_type() == cpp_struct_t);
 
+                // comment is shared with the class
+                REQUIRE(c->get_comment() == "/// c");
+                REQUIRE(c->get_comment().data() == c->get_class().get_comment().data());
+
                 auto size = 0u;
                 for (auto &param : c->get_template_parameters())
                 {
@@ -38,8 +38,8 @@ TEST_CASE("cpp_type_alias", "[cpp]")
         typedef void(*type_7)(int, char);
     )";
 
-    auto tu = parse(p, "cpp_type_alias", code);
-    tu.build_ast();
+    // translation unit is destroyed right away, the full names must still be available
+    parse(p, "cpp_type_alias", code).build_ast();
 
     auto count = 0u;
     p.for_each_type([&](const cpp_type &e)
@@ -0,0 +1,204 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/entity_filter.hpp>
+
+#include <catch.hpp>
+#include <standardese/cpp_class.hpp>
+#include <standardese/cpp_enum.hpp>
+#include <standardese/cpp_namespace.hpp>
+
+#include "test_parser.hpp"
+
+using namespace standardese;
+
+namespace
+{
+    std::string get_names(const cpp_entity_container<cpp_entity> &container)
+    {
+        std::string result;
+        for (auto& e : container)
+        {
+            if (!result.empty())
+                result += ' ';
+            result += e.get_name();
+        }
+        return result;
+    }
+}
+
+TEST_CASE("entity_filter", "[cpp]")
+{
+    parser p;
+    entity_filter filter;
+
+    SECTION("blacklist_namespace")
+    {
+        auto code = R"(
+            namespace detail
+            {
+                struct a {};
+            }
+
+            namespace foo
+            {
+                namespace impl
+                {
+                    void b();
+                }
+
+                namespace detail {}
+
+                void c();
+            }
+
+            namespace impl {}
+        )";
+
+        filter.blacklist_namespace("detail");
+        filter.blacklist_namespace("foo::impl");
+        p.set_filter(filter);
+
+        auto tu = parse(p, "entity_filter__blacklist_namespace", code);
+        auto& file = tu.build_ast();
+        REQUIRE(get_names(file) == "foo impl");
+
+        auto& foo = dynamic_cast<const cpp_namespace&>(*file.begin());
+        REQUIRE(get_names(foo) == "c");
+    }
+    SECTION("blacklist_type")
+    {
+        auto code = R"(
+            #define A
+
+            struct b
+            {
+                void c();
+
+                int d;
+
+                using e = int;
+            };
+
+            using f = int;
+
+            enum g
+            {
+                g_0
+            };
+        )";
+
+        filter.blacklist_type(cpp_entity::macro_definition_t);
+        filter.blacklist_type(cpp_entity::type_alias_t);
+        filter.blacklist_type(cpp_entity::enum_value_t);
+        p.set_filter(filter);
+
+        auto tu = parse(p, "entity_filter__blacklist_type", code);
+        auto& file = tu.build_ast();
+        REQUIRE(get_names(file) == "b g");
+
+        auto& b = dynamic_cast<const cpp_class&>(*file.begin());
+        REQUIRE(get_names(b) == "c d");
+
+        auto& g = dynamic_cast<const cpp_enum&>(*std::next(file.begin()));
+        REQUIRE(g.empty());
+    }
+    SECTION("blacklist_type specialization")
+    {
+        auto code = R"(
+            template <typename T>
+            void a(T);
+
+            template <>
+            void a(int);
+
+            void b();
+        )";
+
+        filter.blacklist_type(cpp_entity::function_t);
+        p.set_filter(filter);
+
+        auto tu = parse(p, "entity_filter__blacklist_type_specialization", code);
+        auto& file = tu.build_ast();
+        REQUIRE(std::distance(file.begin(), file.end()) == 2);
+        REQUIRE(std::next(file.begin())->get_entity_type() == cpp_entity::function_template_specialization_t);
+    }
+    SECTION("minimum_access")
+    {
+        auto code = R"(
+            class a
+            {
+                void b();
+
+                /// c
+                int c;
+
+            protected:
+                struct d
+                {
+                    void inner();
+                };
+
+            public:
+                a();
+            };
+
+            struct e : private a
+            {
+                int f;
+            };
+        )";
+
+        filter.set_minimum_access(cpp_public);
+        p.set_filter(filter);
+
+        auto tu = parse(p, "entity_filter__minimum_access", code);
+        auto& file = tu.build_ast();
+
+        auto& a = dynamic_cast<const cpp_class&>(*file.begin());
+        REQUIRE(get_names(a) == "c protected public a");
+
+        auto& e = dynamic_cast<const cpp_class&>(*std::next(file.begin()));
+        REQUIRE(get_names(e) == "a f");
+    }
+    SECTION("documented_only")
+    {
+        auto code = R"(
+            /// a
+            struct a
+            {
+                void member();
+            };
+
+            struct b
+            {
+                /// c
+                void c();
+            };
+
+            namespace ns
+            {
+                /// d
+                void d();
+
+                void e();
+            }
+
+            void f();
+        )";
+
+        filter.set_documented_only(true);
+        p.set_filter(filter);
+
+        auto tu = parse(p, "entity_filter__documented_only", code);
+        auto& file = tu.build_ast();
+        REQUIRE(get_names(file) == "a ns");
+
+        auto& a = dynamic_cast<const cpp_class&>(*file.begin());
+        REQUIRE(get_names(a) == "member");
+
+        auto& ns = dynamic_cast<const cpp_namespace&>(*std::next(file.begin()));
+        REQUIRE(get_names(ns) == "d");
+    }
+}
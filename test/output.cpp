@@ -5,6 +5,8 @@
 #include <standardese/output.hpp>
 
 #include <catch.hpp>
+#include <cstdio>
+#include <iterator>
 
 using namespace standardese;
 
@@ -40,3 +42,23 @@ TEST_CASE("output_stream_base")
         REQUIRE(str.str() == "a\n    b\nc\n");
     }
 }
+
+TEST_CASE("file_update_output")
+{
+    auto write = [](const char *str)
+    {
+        file_update_output out("file_update_output.md");
+        out.write_str(str, std::strlen(str));
+        return out.close();
+    };
+
+    std::remove("file_update_output.md");
+    REQUIRE(write("a\n"));
+    REQUIRE(!write("a\n"));
+    REQUIRE(write("a\nb\n"));
+    REQUIRE(write("c\n"));
+
+    std::ifstream file("file_update_output.md");
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    REQUIRE(contents == "c\n");
+}
@@ -0,0 +1,115 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/parser.hpp>
+
+#include <catch.hpp>
+#include <standardese/cpp_class.hpp>
+#include <standardese/cpp_type.hpp>
+
+#include "test_parser.hpp"
+
+using namespace standardese;
+
+TEST_CASE("parser", "[cpp]")
+{
+    parser p;
+
+    SECTION("pch")
+    {
+        std::ofstream("parser__pch_header") << R"(
+            #pragma once
+
+            #define PCH_MACRO int
+
+            struct pch_base {};
+        )";
+        p.build_pch({"parser__pch_header"}, cpp_standard::cpp_14, "parser__pch.pch");
+        p.set_pch("parser__pch.pch");
+        REQUIRE(p.get_pch() == "parser__pch.pch");
+
+        auto code = R"(
+            #include "parser__pch_header"
+
+            struct derived : pch_base
+            {
+                PCH_MACRO member;
+            };
+        )";
+
+        auto tu = parse(p, "parser__pch", code);
+        auto& file = tu.build_ast();
+        REQUIRE(std::distance(file.begin(), file.end()) == 2);
+
+        auto& derived = dynamic_cast<const cpp_class&>(*std::next(file.begin()));
+        REQUIRE(derived.get_name() == "derived");
+
+        auto& base = dynamic_cast<const cpp_base_class&>(*derived.begin());
+        REQUIRE(base.get_name() == "pch_base");
+
+        auto& member = *std::next(derived.begin());
+        REQUIRE(member.get_name() == "member");
+    }
+    SECTION("pch error")
+    {
+        REQUIRE_THROWS_AS(p.build_pch({"parser__pch_missing"}, cpp_standard::cpp_14, "parser__pch_missing.pch"),
+                          std::runtime_error);
+    }
+    SECTION("includes")
+    {
+        std::ofstream("parser__includes_b") << "#include \"parser__includes_c\"\n";
+        std::ofstream("parser__includes_c") << "\n";
+
+        auto code = R"(
+            #include "parser__includes_b"
+            #include "parser__includes_c"
+        )";
+
+        auto tu = parse(p, "parser__includes", code);
+        auto includes = tu.get_includes();
+        REQUIRE(includes.size() == 2u);
+
+        auto ends_with = [](const std::string &str, const std::string &suffix)
+        {
+            return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+        };
+        REQUIRE(ends_with(includes[0], "parser__includes_b"));
+        REQUIRE(ends_with(includes[1], "parser__includes_c"));
+    }
+    SECTION("memory usage")
+    {
+        auto tu = parse(p, "parser__memory_usage", "struct a {};");
+        REQUIRE(tu.get_memory_usage() > 0u);
+    }
+    SECTION("edited file")
+    {
+        auto tu = parse(p, "parser__edited_file", "/// comment\nstruct a {};");
+        auto& file = tu.build_ast();
+
+        // the comment doesn't refer to the file on disk
+        std::ofstream("parser__edited_file") << "";
+        REQUIRE(file.begin()->get_comment() == "/// comment");
+    }
+    SECTION("parse error")
+    {
+        REQUIRE_THROWS_AS(p.parse("parser__parse_missing", cpp_standard::cpp_14), std::runtime_error);
+    }
+    SECTION("reparse")
+    {
+        p.set_precompiled_preamble(true);
+        REQUIRE(p.has_precompiled_preamble());
+
+        auto tu = parse(p, "parser__reparse", "struct a {};");
+        REQUIRE(tu.build_ast().begin()->get_name() == "a");
+
+        std::ofstream("parser__reparse") << "struct b_type {};";
+        p.reparse(tu);
+        auto& file = tu.build_ast();
+        REQUIRE(file.begin()->get_name() == "b_type");
+
+        std::string types;
+        p.for_each_type([&](const cpp_type &t) {types += t.get_name();});
+        REQUIRE(types == "b_type");
+    }
+}
@@ -11,10 +11,10 @@
 #include <boost/program_options.hpp>
 
 #include <standardese/comment.hpp>
-#include <standardese/generator.hpp>
 #include <standardese/parser.hpp>
 
-#include "filesystem.hpp"
+#include "run.hpp"
+#include "shard.hpp"
 
 namespace fs = boost::filesystem;
 namespace po = boost::program_options;
@@ -67,13 +67,81 @@ void handle_unparsed_options(const po::parsed_options &options)
         }
 }
 
+standardese::cpp_access_specifier_t parse_access(const std::string &str)
+{
+    using namespace standardese;
+
+    if (str == "private")
+        return cpp_private;
+    else if (str == "protected")
+        return cpp_protected;
+    else if (str == "public")
+        return cpp_public;
+    throw std::invalid_argument("invalid access '" + str + "'");
+}
+
+standardese::preprocessor_mode parse_preprocessor_mode(const std::string &str)
+{
+    using namespace standardese;
+
+    if (str == "detailed")
+        return preprocessor_detailed;
+    else if (str == "scan")
+        return preprocessor_scan;
+    else if (str == "none")
+        return preprocessor_none;
+    throw std::invalid_argument("invalid preprocessor mode '" + str + "'");
+}
+
+// all options that affect the output, for the manifest
+std::string get_options_signature(const po::parsed_options &options)
+{
+    std::string result = "standardese " + std::to_string(STANDARDESE_VERSION_MAJOR)
+                         + '.' + std::to_string(STANDARDESE_VERSION_MINOR) + '\n';
+    for (auto& opt : options.options)
+    {
+        if (opt.string_key == "input-files" || opt.string_key == "shard" || opt.string_key == "jobs"
+            || opt.string_key == "max-memory" || opt.string_key == "isolate"
+            || opt.string_key == "watch" || opt.string_key == "serve")
+            continue;
+
+        result += opt.string_key;
+        for (auto& value : opt.value)
+            result += ' ' + value;
+        result += '\n';
+    }
+    return result;
+}
+
 int main(int argc, char** argv)
 {
     po::options_description generic("Generic options"), configuration("Configuration");
     generic.add_options()
             ("version,v", "prints version information and exits")
             ("help,h", "prints this help message and exits")
-            ("config,c", po::value<fs::path>(), "read options from additional config file as well");
+            ("config,c", po::value<fs::path>(), "read options from additional config file as well")
+            ("shard", po::value<std::string>(),
+             "only process shard i of N (\"i/N\", zero-based) of the input files, "
+             "the other shards can be processed on other machines, not with output.incremental")
+            ("merge", po::value<unsigned>(),
+             "combine the indices written by the given number of shards into standardese.index and exit")
+            ("jobs,j", po::value<unsigned>()->default_value(1u),
+             "number of files parsed in parallel, the most expensive ones according to earlier runs "
+             "(recorded in standardese.costs) are started first")
+            ("max-memory", po::value<unsigned>(),
+             "memory in MiB the translation units parsed in parallel may use, "
+             "estimated from the memory of earlier runs, no new file is started if it would be exceeded")
+            ("isolate",
+             "parse the files in separate worker processes (as many as jobs), "
+             "so a crash only affects the file being parsed, failed files are retried once")
+            ("watch",
+             "keep running after generating the documentation and regenerate it "
+             "whenever an input file or one of its includes changes")
+            ("serve", po::value<std::string>(),
+             "keep running after generating the documentation of the input files (if any) "
+             "and answer requests on the given Unix socket, one JSON object per line: "
+             "{\"command\": \"generate\", \"file\": ...}, "
+             "{\"command\": \"render\", \"entity\": ..., \"file\": ...} or {\"command\": \"shutdown\"}");
     configuration.add_options()
             ("input.blacklist_ext",
              po::value<std::vector<std::string>>()->default_value({}, "(none)"),
@@ -85,6 +153,22 @@ int main(int argc, char** argv)
              po::value<std::vector<std::string>>()->default_value({}, "(none)"),
              "directory that is forbidden, relative to traversed directory")
             ("input.force_blacklist", "force the blacklist for explictly given files")
+            ("input.blacklist_namespace",
+             po::value<std::vector<std::string>>()->default_value({}, "(none)"),
+             "namespace whose entities aren't parsed at all (e.g. \"detail\" or \"foo::impl\")")
+            ("input.documented_only", "don't parse entities in a namespace without a comment")
+            ("input.min_access", po::value<std::string>()->default_value("private"),
+             "don't parse class members with a lower access that don't have a comment "
+             "(\"private\", \"protected\" or \"public\")")
+            ("input.batch",
+             "parse all files of an input directory in a single translation unit, "
+             "so the includes they have in common are only parsed once")
+            ("input.pch",
+             "precompile the system headers included by most input files of a directory, "
+             "so they are only parsed once")
+            ("input.preprocessor", po::value<std::string>()->default_value("detailed"),
+             "how macros and includes are parsed: \"detailed\" preprocessing record, "
+             "cheaper \"scan\" of the file without conditional compilation or \"none\"")
 
             ("comment.command_character", po::value<char>()->default_value('\\'),
              "character used to introduce special commands")
@@ -93,7 +177,15 @@ int main(int argc, char** argv)
 
             ("output.section_name_", po::value<std::string>(),
              "override output name for the section following the name_ (e.g. output.section_name_requires=Require,"
-             "note: override for command name is also required here)");
+             "note: override for command name is also required here)")
+            ("output.snapshot",
+             "also write a binary snapshot (.snapshot) of each file, "
+             "given as input it regenerates the documentation without parsing")
+            ("output.skip_unchanged",
+             "don't write files whose contents didn't change, so their modification time is kept")
+            ("output.incremental",
+             "only generate the documentation of files that have changed, or whose includes have changed, "
+             "since the last run (recorded in standardese.manifest)");
 
 
     po::options_description input("");
@@ -106,6 +198,7 @@ int main(int argc, char** argv)
     cmd.add(generic).add(configuration).add(input);
 
     po::variables_map map;
+    std::string options;
     try
     {
         auto cmd_result = po::command_line_parser(argc, argv).options(cmd)
@@ -132,6 +225,8 @@ int main(int argc, char** argv)
 
         handle_unparsed_options(cmd_result);
         handle_unparsed_options(file_result);
+
+        options = get_options_signature(cmd_result) + get_options_signature(file_result);
     }
     catch (std::exception &ex)
     {
@@ -144,7 +239,23 @@ int main(int argc, char** argv)
         print_usage(argv[0], generic, configuration);
     else if (map.count("version"))
         print_version(argv[0]);
-    else if (map.count("input-files") == 0u)
+    else if (map.count("merge")) try
+    {
+        auto count = map["merge"].as<unsigned>();
+        if (count == 0u)
+            throw std::invalid_argument("invalid number of shards '0'");
+
+        auto index = standardese_tool::merge_shards(count);
+        index.write("standardese.index");
+        std::clog << "Merged " << count << " shards, " << index.no_namespaces() << " namespaces and "
+                  << index.no_types() << " types\n";
+    }
+    catch (std::exception &ex)
+    {
+        std::cerr << "Error: " << ex.what() << '\n';
+        return 1;
+    }
+    else if (map.count("input-files") == 0u && map.count("serve") == 0u)
     {
         std::cerr << "Error: no input file specified\n";
         std::cerr << '\n';
@@ -157,36 +268,80 @@ int main(int argc, char** argv)
 
         comment::parser::set_command_character(map["comment.command_character"].as<char>());
 
-        auto input = map["input-files"].as<std::vector<fs::path>>();
-        auto blacklist_ext = map["input.blacklist_ext"].as<std::vector<std::string>>();
-        auto blacklist_file = map["input.blacklist_file"].as<std::vector<std::string>>();
-        auto blacklist_dir = map["input.blacklist_dir"].as<std::vector<std::string>>();
-        auto force_blacklist = map.count("input.force_blacklist") != 0u;
+        standardese_tool::configuration config;
+        auto input = map.count("input-files") ? map["input-files"].as<std::vector<fs::path>>()
+                                              : std::vector<fs::path>();
+        config.blacklist_ext = map["input.blacklist_ext"].as<std::vector<std::string>>();
+        config.blacklist_file = map["input.blacklist_file"].as<std::vector<std::string>>();
+        config.blacklist_dir = map["input.blacklist_dir"].as<std::vector<std::string>>();
+        config.force_blacklist = map.count("input.force_blacklist") != 0u;
+        config.write_snapshot = map.count("output.snapshot") != 0u;
+        config.batch = map.count("input.batch") != 0u;
+        config.use_pch = map.count("input.pch") != 0u;
+        config.skip_unchanged = map.count("output.skip_unchanged") != 0u;
+        config.isolate = map.count("isolate") != 0u;
+#if defined(_WIN32)
+        if (config.isolate)
+            throw std::invalid_argument("worker processes are not supported on this platform");
+#endif
+        auto watch = map.count("watch") != 0u;
+#if !defined(__linux__)
+        if (watch)
+            throw std::invalid_argument("watching files is not supported on this platform");
+#endif
+        if (watch && (config.batch || config.isolate || map.count("shard")))
+            throw std::invalid_argument("watching files cannot be combined with batches, worker processes or shards");
+        auto serve = map.count("serve") != 0u;
+#if defined(_WIN32)
+        if (serve)
+            throw std::invalid_argument("serving requests is not supported on this platform");
+#endif
+        if (serve && (watch || config.batch || config.isolate || map.count("shard")))
+            throw std::invalid_argument("serving requests cannot be combined with watching files, "
+                                        "batches, worker processes or shards");
+        config.keep = watch || serve;
 
-        assert(!input.empty());
+        // the index of a shard needs the entities of all its files, including the unchanged ones
+        if (map.count("shard") && map.count("output.incremental"))
+            throw std::invalid_argument("shards cannot be combined with incremental output");
 
-        for (auto& path : input)
-        {
-            parser parser;
+        if (map.count("shard"))
+            config.shard.reset(new standardese_tool::shard(standardese_tool::parse_shard(map["shard"].as<std::string>())));
 
-            auto handle = [&](const fs::path &p)
-            {
-                std::clog << "Generating documentation for " << p << "...\n";
+        config.jobs = map["jobs"].as<unsigned>();
+        if (config.jobs == 0u)
+            throw std::invalid_argument("invalid number of jobs '0'");
+        if (config.jobs > 1u || map.count("max-memory"))
+            config.costs.reset(new standardese_tool::cost_history("standardese.costs"));
 
-                auto tu = parser.parse(p.generic_string().c_str(), cpp_standard::cpp_14);
-                auto& f = tu.build_ast();
+        if (map.count("max-memory"))
+            config.memory.reset(new standardese_tool::memory_budget(std::uint64_t(map["max-memory"].as<unsigned>()) << 20,
+                                                                    *config.costs));
 
-                file_output file(p.stem().generic_string() + ".md");
-                markdown_output out(file);
-                generate_doc_file(out, f);
-            };
+        for (auto& name : map["input.blacklist_namespace"].as<std::vector<std::string>>())
+            config.filter.blacklist_namespace(name);
+        config.filter.set_documented_only(map.count("input.documented_only") != 0u);
+        config.filter.set_minimum_access(parse_access(map["input.min_access"].as<std::string>()));
+        config.preprocessor = parse_preprocessor_mode(map["input.preprocessor"].as<std::string>());
 
-            auto res = standardese_tool::handle_path(path, blacklist_ext, blacklist_file, blacklist_dir, handle);
-            if (!res && !force_blacklist)
-                // path is a normal file that is on the blacklist
-                // blacklist isn't enforced however
-                handle(path);
-        }
+        assert(!input.empty() || serve);
+
+        if (map.count("output.incremental"))
+            config.manifest.reset(new standardese_tool::manifest("standardese.manifest", options));
+
+        std::vector<standardese_tool::watched_input> watched;
+        if (!standardese_tool::run_once(config, input, watched))
+            return 1;
+
+#if defined(__linux__)
+        if (watch)
+            standardese_tool::run_watch(config, watched);
+#endif
+
+#if !defined(_WIN32)
+        if (serve)
+            standardese_tool::run_server(config, watched, map["serve"].as<std::string>());
+#endif
     }
     catch (std::exception &ex)
     {
@@ -0,0 +1,245 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_MANIFEST_HPP_INCLUDED
+#define STANDARDESE_MANIFEST_HPP_INCLUDED
+
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <sys/stat.h>
+
+namespace standardese_tool
+{
+    namespace fs = boost::filesystem;
+
+    namespace detail
+    {
+        // FNV-1a
+        inline std::uint64_t hash(const char *data, std::size_t size, std::uint64_t hash = 14695981039346656037ull)
+        {
+            for (auto ptr = data; ptr != data + size; ++ptr)
+            {
+                hash ^= static_cast<unsigned char>(*ptr);
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        // the modification time includes the nanoseconds where the platform has them,
+        // so a change within the same second is noticed
+        inline bool get_file_time(const fs::path &path, std::time_t &time, long &time_nsec, std::uintmax_t &size)
+        {
+            struct stat info;
+            if (::stat(path.string().c_str(), &info) != 0)
+                return false;
+
+            time = info.st_mtime;
+#if defined(_WIN32)
+            time_nsec = 0;
+#elif defined(__APPLE__)
+            time_nsec = info.st_mtimespec.tv_nsec;
+#else
+            time_nsec = info.st_mtim.tv_nsec;
+#endif
+            size = std::uintmax_t(info.st_size);
+            return true;
+        }
+
+        // returns false if the file cannot be read
+        inline bool hash_file(const fs::path &path, std::uint64_t &result)
+        {
+            fs::ifstream in(path, std::ios::binary);
+            if (!in)
+                return false;
+
+            result = 14695981039346656037ull;
+            char buffer[4096];
+            while (in.read(buffer, sizeof(buffer)) || in.gcount() != 0)
+                result = hash(buffer, std::size_t(in.gcount()), result);
+            return true;
+        }
+    } // namespace detail
+
+    // records the files each output was generated from,
+    // so the output isn't generated again as long as none of them changes
+    // it is stored as a text file next to the outputs
+    class manifest
+    {
+    public:
+        // reads the manifest at path, it is empty if it doesn't exist or is invalid
+        // options identifies everything else the outputs depend on,
+        // all entries are invalid if it has changed
+        manifest(fs::path path, const std::string &options)
+        : path_(std::move(path)), options_(detail::hash(options.data(), options.size())), modified_(false)
+        {
+            read();
+        }
+
+        // returns whether the output exists and none of the files it was generated from has changed
+        bool is_unchanged(const fs::path &source, const fs::path &output)
+        {
+            auto iter = entries_.find(source.generic_string());
+            if (iter == entries_.end() || iter->second.output != output.generic_string()
+                || !fs::exists(output))
+                return false;
+
+            for (auto& file : iter->second.files)
+                if (!is_unchanged(file))
+                    return false;
+            return true;
+        }
+
+        // records the files the output was generated from,
+        // the source itself doesn't need to be part of dependencies
+        void update(const fs::path &source, const fs::path &output, const std::vector<std::string> &dependencies)
+        {
+            entry e;
+            e.output = output.generic_string();
+            e.files.reserve(dependencies.size() + 1u);
+
+            file_info info;
+            if (!get_info(source, info))
+                return;
+            e.files.push_back(info);
+
+            for (auto& dependency : dependencies)
+                if (get_info(dependency, info))
+                    e.files.push_back(info);
+
+            entries_[source.generic_string()] = std::move(e);
+            modified_ = true;
+        }
+
+        // writes the manifest if anything has changed
+        void save() const
+        {
+            if (!modified_)
+                return;
+
+            fs::ofstream out(path_);
+            out << "standardese-manifest 2\n";
+            out << "options " << std::hex << options_ << std::dec << '\n';
+            for (auto& e : entries_)
+            {
+                out << "source " << e.first << '\n';
+                out << "output " << e.second.output << '\n';
+                for (auto& file : e.second.files)
+                    out << "file " << file.time << ' ' << file.time_nsec << ' ' << file.size << ' '
+                        << std::hex << file.hash << std::dec << ' ' << file.path << '\n';
+            }
+        }
+
+    private:
+        struct file_info
+        {
+            std::string path;
+            std::time_t time;
+            long time_nsec;
+            std::uintmax_t size;
+            std::uint64_t hash;
+        };
+
+        struct entry
+        {
+            std::string output;
+            std::vector<file_info> files;
+        };
+
+        static bool get_info(const fs::path &path, file_info &info)
+        {
+            info.path = path.generic_string();
+            return detail::get_file_time(path, info.time, info.time_nsec, info.size)
+                && detail::hash_file(path, info.hash);
+        }
+
+        // only hashes the file if the time or size has changed
+        bool is_unchanged(file_info &file)
+        {
+            std::time_t time;
+            long time_nsec;
+            std::uintmax_t size;
+            if (!detail::get_file_time(file.path, time, time_nsec, size))
+                return false;
+            else if (time == file.time && time_nsec == file.time_nsec && size == file.size)
+                return true;
+
+            std::uint64_t hash;
+            if (size != file.size || !detail::hash_file(file.path, hash) || hash != file.hash)
+                return false;
+
+            // same contents, don't hash it again next time
+            file.time = time;
+            file.time_nsec = time_nsec;
+            modified_ = true;
+            return true;
+        }
+
+        void read()
+        {
+            fs::ifstream in(path_);
+            std::string line;
+            if (!std::getline(in, line) || line != "standardese-manifest 2")
+                return;
+
+            auto valid = false;
+            entry *cur = nullptr;
+            while (std::getline(in, line))
+            {
+                auto pos = line.find(' ');
+                if (pos == std::string::npos)
+                {
+                    valid = false;
+                    break;
+                }
+                auto key = line.substr(0, pos);
+                auto value = line.substr(pos + 1);
+
+                if (key == "options")
+                {
+                    std::uint64_t options;
+                    std::istringstream(value) >> std::hex >> options;
+                    // all outputs must be generated again if they have changed
+                    valid = options == options_;
+                }
+                else if (key == "source")
+                    cur = &entries_[value];
+                else if (key == "output" && cur)
+                    cur->output = value;
+                else if (key == "file" && cur)
+                {
+                    std::istringstream stream(value);
+                    file_info info;
+                    stream >> info.time >> info.time_nsec >> info.size >> std::hex >> info.hash >> std::dec;
+                    stream.get(); // space before path
+                    if (!stream || !std::getline(stream, info.path))
+                        valid = false;
+                    cur->files.push_back(std::move(info));
+                }
+                else
+                    valid = false;
+
+                if (!valid)
+                    break;
+            }
+
+            if (!valid)
+                entries_.clear();
+        }
+
+        fs::path path_;
+        std::uint64_t options_;
+        std::map<std::string, entry> entries_;
+        bool modified_;
+    };
+} // namespace standardese_tool
+
+#endif // STANDARDESE_MANIFEST_HPP_INCLUDED
@@ -0,0 +1,112 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_PCH_HPP_INCLUDED
+#define STANDARDESE_PCH_HPP_INCLUDED
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+namespace standardese_tool
+{
+    namespace fs = boost::filesystem;
+
+    // returns the headers included with angle brackets (e.g. "vector" for #include <vector>)
+    // these are the system and third-party headers
+    // only the lines are scanned, so it is cheap but doesn't evaluate conditional compilation
+    inline std::vector<std::string> get_system_includes(const fs::path &path)
+    {
+        std::vector<std::string> result;
+
+        fs::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            auto skip_ws = [&](std::size_t pos)
+            {
+                while (pos < line.size() && std::isspace(static_cast<unsigned char>(line[pos])))
+                    ++pos;
+                return pos;
+            };
+
+            auto pos = skip_ws(0u);
+            if (pos == line.size() || line[pos] != '#')
+                continue;
+
+            pos = skip_ws(pos + 1);
+            if (line.compare(pos, 7, "include") != 0)
+                continue;
+
+            pos = skip_ws(pos + 7);
+            if (pos == line.size() || line[pos] != '<')
+                continue;
+
+            auto end = line.find('>', pos);
+            if (end != std::string::npos)
+                result.push_back(line.substr(pos + 1, end - pos - 1));
+        }
+
+        return result;
+    }
+
+    // returns the system headers included by at least half of the files, but by at least two
+    // in the order they are first included
+    inline std::vector<std::string> get_common_includes(const std::vector<fs::path> &files)
+    {
+        std::vector<std::string> headers;
+        std::map<std::string, std::size_t> count;
+        for (auto& file : files)
+        {
+            // count each header once per file
+            std::set<std::string> seen;
+            for (auto& header : get_system_includes(file))
+                if (seen.insert(header).second && count[header]++ == 0u)
+                    headers.push_back(header);
+        }
+
+        auto min_count = std::max(std::size_t(2u), (files.size() + 1u) / 2u);
+        headers.erase(std::remove_if(headers.begin(), headers.end(),
+                                     [&](const std::string &header)
+                                     {
+                                         return count[header] < min_count;
+                                     }),
+                      headers.end());
+        return headers;
+    }
+
+    // a unique file in the temporary directory that is removed again
+    class temporary_file
+    {
+    public:
+        explicit temporary_file(const char *extension)
+        : path_(fs::temp_directory_path() / fs::unique_path(std::string("standardese-%%%%-%%%%-%%%%") + extension))
+        {}
+
+        temporary_file(const temporary_file&) = delete;
+        temporary_file& operator=(const temporary_file&) = delete;
+
+        ~temporary_file()
+        {
+            boost::system::error_code ec;
+            fs::remove(path_, ec);
+        }
+
+        const fs::path& path() const
+        {
+            return path_;
+        }
+
+    private:
+        fs::path path_;
+    };
+} // namespace standardese_tool
+
+#endif // STANDARDESE_PCH_HPP_INCLUDED
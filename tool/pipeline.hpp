@@ -0,0 +1,147 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_PIPELINE_HPP_INCLUDED
+#define STANDARDESE_PIPELINE_HPP_INCLUDED
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace standardese_tool
+{
+    // passes values from one stage of the pipeline to the next
+    // the capacity limits how far a stage can get ahead of the next one
+    template <typename T>
+    class bounded_queue
+    {
+    public:
+        explicit bounded_queue(std::size_t capacity)
+        : capacity_(capacity == 0u ? 1u : capacity), closed_(false), cancelled_(false) {}
+
+        // blocks while the queue is full,
+        // returns false if it has been cancelled
+        bool push(T value)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_full_.wait(lock, [&] {return cancelled_ || values_.size() < capacity_;});
+            if (cancelled_)
+                return false;
+
+            values_.push_back(std::move(value));
+            not_empty_.notify_one();
+            return true;
+        }
+
+        // blocks while the queue is empty,
+        // returns false once it is closed and empty or cancelled
+        bool pop(T &value)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_empty_.wait(lock, [&] {return cancelled_ || closed_ || !values_.empty();});
+            if (cancelled_ || values_.empty())
+                return false;
+
+            value = std::move(values_.front());
+            values_.pop_front();
+            not_full_.notify_one();
+            return true;
+        }
+
+        // no more values are pushed
+        void close()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            closed_ = true;
+            not_empty_.notify_all();
+        }
+
+        // discards all values and wakes up every blocked thread
+        void cancel()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cancelled_ = true;
+            values_.clear();
+            not_full_.notify_all();
+            not_empty_.notify_all();
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable not_full_, not_empty_;
+        std::deque<T> values_;
+        std::size_t capacity_;
+        bool closed_, cancelled_;
+    };
+
+    // thrown by a stage if the queue of the next stage has been cancelled,
+    // i.e. another stage has failed
+    struct pipeline_cancelled {};
+
+    // the threads of one stage of the pipeline
+    // the first exception of any stage is kept and all queues are cancelled,
+    // so the other stages don't wait forever
+    class pipeline_stage
+    {
+    public:
+        // cancel is called on the first exception
+        pipeline_stage(std::exception_ptr &error, std::mutex &error_mutex, std::function<void()> cancel)
+        : error_(&error), mutex_(&error_mutex), cancel_(std::move(cancel)) {}
+
+        ~pipeline_stage()
+        {
+            join();
+        }
+
+        // runs f on n new threads
+        template <typename Func>
+        void run(unsigned n, Func f)
+        {
+            for (auto i = 0u; i != n; ++i)
+                threads_.emplace_back([this, f]
+                                      {
+                                          call(f);
+                                      });
+        }
+
+        // calls f on the current thread
+        template <typename Func>
+        void call(Func f)
+        {
+            try
+            {
+                f();
+            }
+            catch (...)
+            {
+                std::unique_lock<std::mutex> lock(*mutex_);
+                if (*error_)
+                    return;
+                *error_ = std::current_exception();
+                lock.unlock();
+                cancel_();
+            }
+        }
+
+        void join()
+        {
+            for (auto& t : threads_)
+                t.join();
+            threads_.clear();
+        }
+
+    private:
+        std::vector<std::thread> threads_;
+        std::exception_ptr *error_;
+        std::mutex *mutex_;
+        std::function<void()> cancel_;
+    };
+} // namespace standardese_tool
+
+#endif // STANDARDESE_PIPELINE_HPP_INCLUDED
@@ -0,0 +1,797 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_RUN_HPP_INCLUDED
+#define STANDARDESE_RUN_HPP_INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <standardese/ast_snapshot.hpp>
+#include <standardese/generator.hpp>
+#include <standardese/parser.hpp>
+
+#include "filesystem.hpp"
+#include "manifest.hpp"
+#include "pch.hpp"
+#include "pipeline.hpp"
+#include "schedule.hpp"
+#include "server.hpp"
+#include "shard.hpp"
+#include "watch.hpp"
+#include "worker.hpp"
+
+namespace standardese_tool
+{
+    namespace fs = boost::filesystem;
+
+    // the options given to the tool and the state shared by the modes it runs in
+    struct configuration
+    {
+        std::vector<std::string> blacklist_ext, blacklist_file, blacklist_dir;
+        bool force_blacklist, batch, use_pch;
+        standardese::entity_filter filter;
+        standardese::preprocessor_mode preprocessor;
+
+        bool write_snapshot, skip_unchanged;
+        // keeps the parsers and translation units, to reparse the files later
+        bool keep;
+        bool isolate;
+        unsigned jobs;
+
+        std::unique_ptr<standardese_tool::shard> shard;
+        entity_index index;
+        std::unique_ptr<cost_history> costs;
+        std::unique_ptr<memory_budget> memory;
+        std::unique_ptr<standardese_tool::manifest> manifest;
+
+        // the number of files since the counters were last reset
+        unsigned written, unchanged, failed;
+        std::mutex log_mutex;
+
+        configuration()
+        : force_blacklist(false), batch(false), use_pch(false),
+          preprocessor(standardese::preprocessor_detailed),
+          write_snapshot(false), skip_unchanged(false), keep(false), isolate(false), jobs(1u),
+          written(0u), unchanged(0u), failed(0u) {}
+    };
+
+    // what is kept for run_watch() and run_server(): the parsers and the translation units of the files
+    struct watched_file
+    {
+        fs::path path;
+        // null if the last parse failed
+        std::unique_ptr<standardese::translation_unit> tu;
+        const standardese::cpp_file *ast;
+        std::vector<std::string> includes;
+        // when the parse started, a file modified since then is outdated
+        std::time_t time;
+    };
+
+    struct watched_input
+    {
+        std::unique_ptr<standardese::parser> parser;
+        std::unique_ptr<temporary_file> pch;
+        std::vector<watched_file> files;
+    };
+
+    inline fs::path get_output(const fs::path &p)
+    {
+        return fs::path(p.stem().generic_string() + ".md");
+    }
+
+    inline void log(configuration &config, const fs::path &p)
+    {
+        std::unique_lock<std::mutex> lock(config.log_mutex);
+        std::clog << "Generating documentation for " << p << "...\n";
+    }
+
+    inline std::string render_doc(const standardese::ast_snapshot &snapshot)
+    {
+        std::ostringstream doc;
+        standardese::streambuf_output file(doc);
+        standardese::markdown_output out(file);
+        standardese::generate_doc_file(out, snapshot);
+        return doc.str();
+    }
+
+    // returns whether the file was written
+    inline bool write_file(const configuration &config, const fs::path &output, const std::string &doc)
+    {
+        if (config.skip_unchanged)
+        {
+            standardese::file_update_output file(output.generic_string());
+            file.write_str(doc.data(), doc.size());
+            return file.close();
+        }
+
+        std::ofstream file(output.generic_string());
+        file << doc;
+        return true;
+    }
+
+    inline void write_doc(configuration &config, const fs::path &output, const std::string &doc)
+    {
+        if (write_file(config, output, doc))
+            ++config.written;
+        else
+            ++config.unchanged;
+    }
+
+#if !defined(_WIN32)
+    // parses the files in worker processes, which also write them,
+    // they report what is needed for the manifest, history and index
+    // it must be called while no other thread is running,
+    // as forking a process, also to replace a crashed one, requires a single thread
+    inline void run_isolated(configuration &config, standardese::parser &parser,
+                             const std::vector<fs::path> &parse_files)
+    {
+        using namespace standardese;
+
+        // each process has its own copy of the parser and of sent
+        entity_index sent;
+        auto process = [&](const std::string &request)
+        {
+            std::ostringstream response;
+            try
+            {
+                fs::path p(request);
+
+                auto start = std::chrono::steady_clock::now();
+                const cpp_file *f;
+                std::vector<std::string> includes;
+                std::size_t usage;
+                {
+                    auto tu = parser.parse(p.generic_string().c_str(), cpp_standard::cpp_14);
+                    f = &tu.build_ast();
+                    if (config.manifest)
+                        includes = tu.get_includes();
+                    usage = tu.get_memory_usage();
+                }
+                auto parsed = std::chrono::steady_clock::now();
+
+                ast_snapshot snapshot(*f);
+                auto changed = write_file(config, get_output(p), render_doc(snapshot));
+                if (config.write_snapshot)
+                {
+                    std::ofstream snapshot_file(p.stem().generic_string() + ".snapshot", std::ios::binary);
+                    snapshot.save(snapshot_file);
+                }
+
+                using std::chrono::duration_cast;
+                using duration = cost_history::duration;
+                response << (changed ? "written" : "unchanged") << '\n';
+                response << duration_cast<duration>(parsed - start).count() << ' '
+                         << duration_cast<duration>(std::chrono::steady_clock::now() - parsed).count() << ' '
+                         << usage << '\n';
+                for (auto& include : includes)
+                    response << "include " << include << '\n';
+
+                if (config.shard)
+                {
+                    // only the entries not sent with an earlier file
+                    entity_index cur;
+                    cur.add(parser);
+                    cur.write_entries(response, sent);
+                    sent.add(cur);
+                }
+            }
+            catch (std::exception &ex)
+            {
+                return std::string("error ") + ex.what();
+            }
+            return response.str();
+        };
+
+        std::vector<fs::path> retry;
+        auto run_workers = [&](const std::vector<fs::path> &files, unsigned size, bool last_try)
+        {
+            using reservation = memory_budget::reservation;
+            std::map<std::string, std::unique_ptr<reservation>> reservations;
+
+            worker_pool pool(size, process);
+            auto next = files.begin();
+            while (true)
+            {
+                while (next != files.end() && pool.idle() && (!config.memory || config.memory->can_acquire(*next)))
+                {
+                    if (config.memory)
+                        reservations[next->generic_string()].reset(new reservation(config.memory->acquire(*next)));
+                    log(config, *next);
+                    pool.send(next->generic_string());
+                    ++next;
+                }
+
+                worker_pool::result result;
+                if (!pool.receive(result))
+                    break;
+                fs::path p(result.request);
+                auto res = std::move(reservations[result.request]);
+                reservations.erase(result.request);
+
+                std::string error;
+                if (result.crashed)
+                    error = result.response;
+                else if (result.response.compare(0, 6, "error ") == 0)
+                    error = result.response.substr(6);
+                if (!error.empty())
+                {
+                    if (last_try)
+                    {
+                        std::cerr << "Error: unable to generate documentation for " << p << ": "
+                                  << error << '\n';
+                        ++config.failed;
+                    }
+                    else
+                    {
+                        std::cerr << "Warning: unable to generate documentation for " << p << ": "
+                                  << error << ", retrying later\n";
+                        retry.push_back(p);
+                    }
+                    continue;
+                }
+
+                std::istringstream response(result.response);
+                std::string line;
+                std::getline(response, line);
+                if (line == "written")
+                    ++config.written;
+                else
+                    ++config.unchanged;
+
+                std::uint64_t parse_time, generate_time, usage;
+                response >> parse_time >> generate_time >> usage;
+                response.ignore(1); // newline
+                if (config.costs)
+                {
+                    using duration = cost_history::duration;
+                    config.costs->record(p, duration(parse_time), duration(generate_time));
+                    config.costs->record_memory(p, usage);
+                }
+                if (res)
+                    res->update(usage);
+
+                std::vector<std::string> includes;
+                while (std::getline(response, line))
+                    if (line.compare(0, 8, "include ") == 0)
+                        includes.push_back(line.substr(8));
+                    else
+                        config.index.add_entry(line);
+                if (config.manifest)
+                    config.manifest->update(p, get_output(p), includes);
+            }
+        };
+
+        run_workers(parse_files, config.jobs, false);
+        if (!retry.empty())
+        {
+            // one at a time, so the file doesn't fail because of the others
+            std::clog << "Retrying " << retry.size() << " files...\n";
+            run_workers(retry, 1u, true);
+        }
+    }
+#endif
+
+    // generates the documentation of the inputs once and writes the shard index, manifest and history,
+    // the parsed files are returned if config.keep is set
+    // returns false if a file failed in a worker process
+    inline bool run_once(configuration &config, const std::vector<fs::path> &input,
+                         std::vector<watched_input> &watched)
+    {
+        using namespace standardese;
+
+        for (auto& path : input)
+        {
+            std::unique_ptr<standardese::parser> parser_ptr(new standardese::parser);
+            auto& parser = *parser_ptr;
+            parser.set_filter(config.filter);
+            parser.set_preprocessor_mode(config.preprocessor);
+            // makes reparsing cheaper, at the cost of a slower first parse
+            parser.set_precompiled_preamble(config.keep);
+
+            std::vector<fs::path> batch_files, parse_files;
+            auto handle = [&](const fs::path &p)
+            {
+                if (p.extension() == ".snapshot")
+                {
+                    log(config, p);
+
+                    write_doc(config, get_output(p), render_doc(ast_snapshot::load(p.generic_string().c_str())));
+
+                    if (config.manifest)
+                        config.manifest->update(p, get_output(p), {});
+                }
+                else if (config.batch)
+                    batch_files.push_back(p);
+                else
+                    parse_files.push_back(p);
+            };
+
+            std::vector<fs::path> files;
+            auto res = handle_path(path, config.blacklist_ext, config.blacklist_file, config.blacklist_dir,
+                                   [&](const fs::path &p) {files.push_back(p);});
+            if (!res && !config.force_blacklist)
+                // path is a normal file that is on the blacklist
+                // blacklist isn't enforced however
+                files.push_back(path);
+
+            if (config.shard)
+                files = select_shard(files, *config.shard);
+
+            if (config.manifest)
+                files.erase(std::remove_if(files.begin(), files.end(),
+                                           [&](const fs::path &p)
+                                           {
+                                               if (!config.manifest->is_unchanged(p, get_output(p))
+                                                   || (config.write_snapshot && p.extension() != ".snapshot"
+                                                       && !fs::exists(p.stem().generic_string() + ".snapshot")))
+                                                   return false;
+
+                                               std::clog << "Skipping " << p << ", it is unchanged\n";
+                                               return true;
+                                           }),
+                            files.end());
+
+            // precompile the system headers most files include,
+            // so they aren't parsed again for each of them
+            std::unique_ptr<temporary_file> pch(new temporary_file(".pch"));
+            if (config.use_pch)
+            {
+                std::vector<fs::path> sources;
+                for (auto& p : files)
+                    if (p.extension() != ".snapshot")
+                        sources.push_back(p);
+
+                auto headers = get_common_includes(sources);
+                if (!headers.empty())
+                {
+                    std::clog << "Precompiling " << headers.size() << " common headers...\n";
+                    try
+                    {
+                        parser.build_pch(headers, cpp_standard::cpp_14, pch->path().string().c_str());
+                        parser.set_pch(pch->path().string());
+                    }
+                    catch (std::runtime_error &ex)
+                    {
+                        std::cerr << "Warning: " << ex.what() << ", parsing without it\n";
+                    }
+                }
+            }
+
+            for (auto& p : files)
+                handle(p);
+
+            if (config.costs)
+                sort_by_cost(parse_files, *config.costs);
+
+#if !defined(_WIN32)
+            // before the threads of the pipeline are started
+            if (config.isolate)
+            {
+                run_isolated(config, parser, parse_files);
+                parse_files.clear();
+            }
+#endif
+
+            // the files pass through three stages: parsing, rendering and writing
+            // the queues between them limit how many ASTs and documents are waiting,
+            // and the stages run concurrently, so the CPU and disk are busy at the same time
+            struct parsed_file
+            {
+                fs::path path;
+                const cpp_file *file;
+                std::vector<std::string> includes;
+                std::chrono::steady_clock::duration parse_time;
+            };
+
+            struct rendered_file
+            {
+                fs::path path;
+                std::string doc, snapshot;
+                std::vector<std::string> includes;
+            };
+
+            bounded_queue<parsed_file> parsed(config.jobs);
+            bounded_queue<rendered_file> rendered(config.jobs);
+
+            std::exception_ptr error;
+            std::mutex error_mutex;
+            auto cancel = [&]
+            {
+                parsed.cancel();
+                rendered.cancel();
+            };
+            pipeline_stage parse_stage(error, error_mutex, cancel),
+                           render_stage(error, error_mutex, cancel),
+                           write_stage(error, error_mutex, cancel);
+
+            auto push_parsed = [&](parsed_file f)
+            {
+                if (!parsed.push(std::move(f)))
+                    throw pipeline_cancelled();
+            };
+
+            render_stage.run(config.jobs, [&]
+            {
+                parsed_file f;
+                while (parsed.pop(f))
+                {
+                    auto start = std::chrono::steady_clock::now();
+
+                    ast_snapshot snapshot(*f.file);
+                    rendered_file result{f.path, render_doc(snapshot), "", std::move(f.includes)};
+                    if (config.write_snapshot)
+                    {
+                        std::ostringstream out;
+                        snapshot.save(out);
+                        result.snapshot = out.str();
+                    }
+
+                    // files parsed in a batch aren't timed individually
+                    if (config.costs && f.parse_time != std::chrono::steady_clock::duration::zero())
+                    {
+                        using std::chrono::duration_cast;
+                        using duration = cost_history::duration;
+                        config.costs->record(f.path, duration_cast<duration>(f.parse_time),
+                                             duration_cast<duration>(std::chrono::steady_clock::now() - start));
+                    }
+
+                    if (!rendered.push(std::move(result)))
+                        throw pipeline_cancelled();
+                }
+            });
+
+            // a single writer, so only one file is written at a time
+            write_stage.run(1u, [&]
+            {
+                rendered_file f;
+                while (rendered.pop(f))
+                {
+                    write_doc(config, get_output(f.path), f.doc);
+
+                    if (config.write_snapshot)
+                    {
+                        std::ofstream snapshot_file(f.path.stem().generic_string() + ".snapshot", std::ios::binary);
+                        snapshot_file << f.snapshot;
+                    }
+
+                    if (config.manifest)
+                        config.manifest->update(f.path, get_output(f.path), f.includes);
+                }
+            });
+
+            std::mutex watched_mutex;
+            std::vector<watched_file> kept;
+            parse_stage.call([&]
+            {
+                for_each_parallel(parse_files, config.jobs, [&](const fs::path &p)
+                {
+                    std::unique_ptr<memory_budget::reservation> reservation;
+                    if (config.memory)
+                        reservation.reset(new memory_budget::reservation(config.memory->acquire(p)));
+
+                    log(config, p);
+
+                    auto start = std::chrono::steady_clock::now();
+                    parsed_file f;
+                    f.path = p;
+                    {
+                        // translation unit is destroyed right away unless it is kept, the AST doesn't need it
+                        auto time = std::time(nullptr);
+                        auto tu = parser.parse(p.generic_string().c_str(), cpp_standard::cpp_14);
+                        f.file = &tu.build_ast();
+                        if (config.manifest || config.keep)
+                            f.includes = tu.get_includes();
+
+                        if (config.costs)
+                        {
+                            auto usage = tu.get_memory_usage();
+                            config.costs->record_memory(p, usage);
+                            if (reservation)
+                                reservation->update(usage);
+                        }
+
+                        if (config.keep)
+                        {
+                            std::unique_lock<std::mutex> lock(watched_mutex);
+                            std::unique_ptr<translation_unit> ptr(new translation_unit(std::move(tu)));
+                            kept.push_back(watched_file{p, std::move(ptr), f.file, f.includes, time});
+                        }
+                    }
+                    reservation.reset();
+                    f.parse_time = std::chrono::steady_clock::now() - start;
+
+                    push_parsed(std::move(f));
+                });
+            });
+
+            if (!batch_files.empty())
+                parse_stage.call([&]
+                {
+                    std::vector<std::string> paths;
+                    for (auto& p : batch_files)
+                        paths.push_back(p.generic_string());
+
+                    std::clog << "Parsing " << paths.size() << " files in a single translation unit...\n";
+                    auto units = parser.parse(paths, cpp_standard::cpp_14);
+                    auto files = translation_unit::build_ast(units);
+                    for (std::size_t i = 0u; i != files.size(); ++i)
+                    {
+                        log(config, batch_files[i]);
+                        push_parsed({batch_files[i], files[i],
+                                     config.manifest ? units[i].get_includes() : std::vector<std::string>(),
+                                     {}});
+                    }
+                });
+
+            parsed.close();
+            render_stage.join();
+            rendered.close();
+            write_stage.join();
+            if (error)
+                std::rethrow_exception(error);
+
+            if (config.shard)
+                config.index.add(parser);
+            if (config.keep)
+                watched.push_back(watched_input{std::move(parser_ptr), std::move(pch), std::move(kept)});
+        }
+
+        if (config.shard)
+            config.index.write(get_shard_index_path(*config.shard));
+
+        if (config.manifest)
+            config.manifest->save();
+        if (config.costs)
+            config.costs->save();
+
+        std::clog << config.written << " files written";
+        if (config.skip_unchanged)
+            std::clog << ", " << config.unchanged << " unchanged";
+        std::clog << '\n';
+        if (config.memory)
+            std::clog << "Peak memory of the translation units: " << (config.memory->peak() >> 20) << " MiB\n";
+        if (config.failed != 0u)
+        {
+            std::cerr << "Error: " << config.failed << " files failed\n";
+            return false;
+        }
+        return true;
+    }
+
+    // parses the file again, or for the first time if it wasn't parsed successfully
+    inline void update_file(configuration &config, watched_input &in, watched_file &file)
+    {
+        log(config, file.path);
+        try
+        {
+            file.time = std::time(nullptr);
+            // a translation unit whose parse failed cannot be reparsed
+            if (file.tu)
+                in.parser->reparse(*file.tu);
+            else
+                file.tu.reset(new standardese::translation_unit(
+                    in.parser->parse(file.path.generic_string().c_str(), standardese::cpp_standard::cpp_14)));
+            file.ast = &file.tu->build_ast();
+            file.includes = file.tu->get_includes();
+        }
+        catch (...)
+        {
+            file.tu.reset();
+            file.ast = nullptr;
+            throw;
+        }
+    }
+
+    inline void regenerate(configuration &config, watched_input &in, watched_file &file)
+    {
+        update_file(config, in, file);
+
+        standardese::ast_snapshot snapshot(*file.ast);
+        write_doc(config, get_output(file.path), render_doc(snapshot));
+        if (config.write_snapshot)
+        {
+            std::ofstream snapshot_file(file.path.stem().generic_string() + ".snapshot", std::ios::binary);
+            snapshot.save(snapshot_file);
+        }
+
+        if (config.manifest)
+            config.manifest->update(file.path, get_output(file.path), file.includes);
+    }
+
+#if defined(__linux__)
+    // regenerates the documentation of the watched files whenever they or one of their includes change,
+    // never returns
+    inline void run_watch(configuration &config, std::vector<watched_input> &watched)
+    {
+        file_watcher watcher;
+        for (auto& in : watched)
+            for (auto& file : in.files)
+            {
+                watcher.add_file(file.path);
+                for (auto& include : file.includes)
+                    watcher.add_file(include);
+            }
+
+        while (true)
+        {
+            std::clog << "Watching " << watcher.no_files() << " files for changes...\n";
+            auto changed = watcher.wait();
+
+            config.written = config.unchanged = 0u;
+            for (auto& in : watched)
+                for (auto& file : in.files)
+                {
+                    auto affected = changed.count(get_watch_path(file.path)) != 0u;
+                    for (auto& include : file.includes)
+                        affected = affected || changed.count(get_watch_path(include));
+                    if (!affected)
+                        continue;
+
+                    try
+                    {
+                        regenerate(config, in, file);
+                        for (auto& include : file.includes)
+                            watcher.add_file(include);
+                    }
+                    catch (std::exception &ex)
+                    {
+                        std::cerr << "Error: " << ex.what() << '\n';
+                    }
+                }
+
+            if (config.manifest)
+                config.manifest->save();
+            std::clog << config.written << " files written";
+            if (config.skip_unchanged)
+                std::clog << ", " << config.unchanged << " unchanged";
+            std::clog << '\n';
+        }
+    }
+#endif
+
+#if !defined(_WIN32)
+    // answers the requests on the Unix socket until it is shut down,
+    // the requested files are added to the watched ones
+    inline void run_server(configuration &config, std::vector<watched_input> &watched, const std::string &socket)
+    {
+        using namespace standardese;
+
+        if (watched.empty())
+        {
+            // files requested later are parsed with the configuration of the first input
+            std::unique_ptr<standardese::parser> parser(new standardese::parser);
+            parser->set_filter(config.filter);
+            parser->set_preprocessor_mode(config.preprocessor);
+            parser->set_precompiled_preamble(true);
+            watched.push_back(watched_input{std::move(parser), nullptr, {}});
+        }
+
+        // returns the kept file, it is added if it isn't known yet
+        auto get_file = [&](const std::string &path) -> std::pair<watched_input*, watched_file*>
+        {
+            auto id = get_watch_path(path);
+            for (auto& in : watched)
+                for (auto& file : in.files)
+                    if (get_watch_path(file.path) == id)
+                        return {&in, &file};
+
+            if (!fs::exists(path))
+                throw std::invalid_argument("file '" + path + "' doesn't exist");
+            auto& in = watched.front();
+            in.files.push_back(watched_file{path, nullptr, nullptr, {}, 0});
+            return {&in, &in.files.back()};
+        };
+
+        // whether the file or one of its includes has been modified since it was parsed
+        auto is_outdated = [](const watched_file &file)
+        {
+            if (!file.ast)
+                return true;
+
+            boost::system::error_code ec;
+            if (fs::last_write_time(file.path, ec) >= file.time || ec)
+                return true;
+            for (auto& include : file.includes)
+                if (fs::last_write_time(include, ec) >= file.time || ec)
+                    return true;
+            return false;
+        };
+
+        auto render_entity = [&](watched_input &in, watched_file &file, const std::string &name,
+                                 std::string &markdown)
+        {
+            if (is_outdated(file))
+                update_file(config, in, file);
+
+            // only the entity and its members are rendered, not the whole file
+            auto entity = find_entity(*file.ast, name);
+            if (!entity)
+                return false;
+
+            std::ostringstream doc;
+            streambuf_output stream(doc);
+            markdown_output out(stream);
+            generate_doc_entity(out, 1u, ast_snapshot(*entity), 0u);
+            markdown = doc.str();
+            return true;
+        };
+
+        unix_server server(socket);
+        std::clog << "Serving requests on " << socket << "...\n";
+        server.run([&](const std::string &line)
+        {
+            json_object response;
+            try
+            {
+                auto request = parse_json_object(line);
+                auto& command = request["command"];
+                if (command == "generate")
+                {
+                    if (request["file"].empty())
+                        throw std::invalid_argument("missing file of request");
+
+                    auto file = get_file(request["file"]);
+                    config.written = config.unchanged = 0u;
+                    regenerate(config, *file.first, *file.second);
+                    if (config.manifest)
+                        config.manifest->save();
+
+                    response["output"] = get_output(file.second->path).generic_string();
+                    response["written"] = config.written != 0u ? "true" : "false";
+                }
+                else if (command == "render")
+                {
+                    auto& name = request["entity"];
+                    if (name.empty())
+                        throw std::invalid_argument("missing entity of request");
+
+                    auto found = false;
+                    if (!request["file"].empty())
+                    {
+                        auto file = get_file(request["file"]);
+                        found = render_entity(*file.first, *file.second, name, response["markdown"]);
+                    }
+                    else
+                        for (auto in = watched.begin(); !found && in != watched.end(); ++in)
+                            for (auto file = in->files.begin(); !found && file != in->files.end(); ++file)
+                                found = render_entity(*in, *file, name, response["markdown"]);
+
+                    if (!found)
+                        throw std::invalid_argument("entity '" + name + "' not found");
+                }
+                else if (command == "shutdown")
+                    server.stop();
+                else
+                    throw std::invalid_argument("invalid command '" + command + "'");
+
+                response["status"] = "ok";
+            }
+            catch (std::exception &ex)
+            {
+                response.clear();
+                response["status"] = "error";
+                response["message"] = ex.what();
+            }
+            return to_json(response);
+        });
+        std::clog << "Shut down\n";
+    }
+#endif
+} // namespace standardese_tool
+
+#endif // STANDARDESE_RUN_HPP_INCLUDED
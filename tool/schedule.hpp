@@ -0,0 +1,338 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_SCHEDULE_HPP_INCLUDED
+#define STANDARDESE_SCHEDULE_HPP_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <standardese/noexcept.hpp>
+
+namespace standardese_tool
+{
+    namespace fs = boost::filesystem;
+
+    // how long parsing and generating the documentation of each file took in earlier runs,
+    // and how much memory its translation unit used
+    // it is stored as a text file next to the outputs
+    class cost_history
+    {
+    public:
+        using duration = std::chrono::microseconds;
+
+        // reads the history at path, it is empty if it doesn't exist or is invalid
+        explicit cost_history(fs::path path)
+        : path_(std::move(path)), modified_(false)
+        {
+            read();
+        }
+
+        // returns the estimated time it takes to process the file in microseconds
+        // files without history are estimated from their size,
+        // using the average time per byte of the known files
+        double estimate(const fs::path &file) const
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto iter = entries_.find(file.generic_string());
+            if (iter != entries_.end())
+                return double(iter->second.parse + iter->second.generate);
+
+            boost::system::error_code ec;
+            auto size = fs::file_size(file, ec);
+            if (ec)
+                return 0.0;
+
+            std::uint64_t total_time = 0u, total_size = 0u;
+            for (auto& e : entries_)
+            {
+                total_time += e.second.parse + e.second.generate;
+                total_size += e.second.size;
+            }
+            return total_size == 0u ? double(size) : double(size) * double(total_time) / double(total_size);
+        }
+
+        // returns the estimated memory of the translation unit of the file in bytes,
+        // or 0 if nothing is known
+        // files without history are estimated from their size,
+        // using the average memory per byte of the known files
+        std::uint64_t estimate_memory(const fs::path &file) const
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto iter = entries_.find(file.generic_string());
+            if (iter != entries_.end() && iter->second.memory != 0u)
+                return iter->second.memory;
+
+            boost::system::error_code ec;
+            auto size = fs::file_size(file, ec);
+            if (ec)
+                return 0u;
+
+            std::uint64_t total_memory = 0u, total_size = 0u;
+            for (auto& e : entries_)
+                if (e.second.memory != 0u)
+                {
+                    total_memory += e.second.memory;
+                    total_size += e.second.size;
+                }
+            return total_size == 0u ? 0u : std::uint64_t(double(size) * double(total_memory) / double(total_size));
+        }
+
+        // thread safe
+        void record(const fs::path &file, duration parse, duration generate)
+        {
+            update(file, [&](entry &e)
+            {
+                e.parse = std::uint64_t(parse.count());
+                e.generate = std::uint64_t(generate.count());
+            });
+        }
+
+        // thread safe
+        void record_memory(const fs::path &file, std::uint64_t memory)
+        {
+            update(file, [&](entry &e)
+            {
+                e.memory = memory;
+            });
+        }
+
+        // writes the history if anything has changed
+        void save() const
+        {
+            if (!modified_)
+                return;
+
+            fs::ofstream out(path_);
+            out << "standardese-costs 2\n";
+            for (auto& e : entries_)
+                out << e.second.parse << ' ' << e.second.generate << ' ' << e.second.memory << ' '
+                    << e.second.size << ' ' << e.first << '\n';
+        }
+
+    private:
+        struct entry
+        {
+            std::uint64_t parse = 0u, generate = 0u, memory = 0u, size = 0u;
+        };
+
+        template <typename Func>
+        void update(const fs::path &file, Func f)
+        {
+            boost::system::error_code ec;
+            auto size = fs::file_size(file, ec);
+            if (ec)
+                return;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto& e = entries_[file.generic_string()];
+            f(e);
+            e.size = size;
+            modified_ = true;
+        }
+
+        void read()
+        {
+            fs::ifstream in(path_);
+            std::string line;
+            if (!std::getline(in, line) || line != "standardese-costs 2")
+                return;
+
+            while (std::getline(in, line))
+            {
+                std::istringstream stream(line);
+                entry e;
+                std::string path;
+                stream >> e.parse >> e.generate >> e.memory >> e.size;
+                stream.get(); // space before path
+                if (!stream || !std::getline(stream, path))
+                {
+                    entries_.clear();
+                    return;
+                }
+                entries_[path] = e;
+            }
+        }
+
+        fs::path path_;
+        mutable std::mutex mutex_;
+        std::map<std::string, entry> entries_;
+        bool modified_;
+    };
+
+    // limits the memory of the translation units parsed at the same time
+    class memory_budget
+    {
+    public:
+        // the memory of a parse, it is released on destruction
+        class reservation
+        {
+        public:
+            reservation(reservation &&other) STANDARDESE_NOEXCEPT
+            : budget_(other.budget_), amount_(other.amount_)
+            {
+                other.budget_ = nullptr;
+            }
+
+            ~reservation() STANDARDESE_NOEXCEPT
+            {
+                if (budget_)
+                    budget_->release(amount_);
+            }
+
+            reservation &operator=(reservation &&) = delete;
+
+            // replaces the estimate with the memory actually used
+            void update(std::uint64_t actual)
+            {
+                budget_->update(amount_, actual);
+                amount_ = actual;
+            }
+
+        private:
+            reservation(memory_budget &budget, std::uint64_t amount) STANDARDESE_NOEXCEPT
+            : budget_(&budget), amount_(amount) {}
+
+            memory_budget *budget_;
+            std::uint64_t amount_;
+
+            friend memory_budget;
+        };
+
+        // limit is in bytes, the estimates are taken from the history
+        memory_budget(std::uint64_t limit, const cost_history &history)
+        : history_(&history), limit_(limit), used_(0u), peak_(0u) {}
+
+        // blocks until the estimated memory of the file fits in the budget
+        // a file whose memory is unknown is only admitted alone,
+        // and a file is always admitted if nothing else is parsed
+        reservation acquire(const fs::path &file)
+        {
+            auto estimate = get_estimate(file);
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            available_.wait(lock, [&] {return used_ == 0u || used_ + estimate <= limit_;});
+            used_ += estimate;
+            return reservation(*this, estimate);
+        }
+
+        // returns whether acquire() wouldn't block
+        bool can_acquire(const fs::path &file) const
+        {
+            auto estimate = get_estimate(file);
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            return used_ == 0u || used_ + estimate <= limit_;
+        }
+
+        // the highest memory used by the translation units at the same time
+        std::uint64_t peak() const
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            return peak_;
+        }
+
+    private:
+        std::uint64_t get_estimate(const fs::path &file) const
+        {
+            auto estimate = history_->estimate_memory(file);
+            return estimate == 0u || estimate > limit_ ? limit_ : estimate;
+        }
+
+        void update(std::uint64_t estimate, std::uint64_t actual)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            used_ = used_ - estimate + actual;
+            peak_ = std::max(peak_, used_);
+            available_.notify_all();
+        }
+
+        void release(std::uint64_t amount)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            used_ -= amount;
+            available_.notify_all();
+        }
+
+        const cost_history *history_;
+        mutable std::mutex mutex_;
+        std::condition_variable available_;
+        std::uint64_t limit_, used_, peak_;
+    };
+
+    // sorts the files so that the most expensive ones come first,
+    // with a parallel run starting them first, none of them is started last and determines the wall time
+    inline void sort_by_cost(std::vector<fs::path> &files, const cost_history &history)
+    {
+        std::vector<std::pair<double, fs::path>> costs;
+        costs.reserve(files.size());
+        for (auto& file : files)
+            costs.emplace_back(history.estimate(file), std::move(file));
+
+        std::stable_sort(costs.begin(), costs.end(),
+                         [](const std::pair<double, fs::path> &a, const std::pair<double, fs::path> &b)
+                         {
+                             return a.first > b.first;
+                         });
+
+        files.clear();
+        for (auto& cost : costs)
+            files.push_back(std::move(cost.second));
+    }
+
+    // calls f for each file using the given number of threads, in order,
+    // rethrows the first exception after all threads have finished
+    template <typename Func>
+    void for_each_parallel(const std::vector<fs::path> &files, unsigned jobs, Func f)
+    {
+        std::atomic<std::size_t> next(0u);
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+        auto worker = [&]
+        {
+            for (auto i = next++; i < files.size(); i = next++)
+            {
+                try
+                {
+                    f(files[i]);
+                }
+                catch (...)
+                {
+                    std::unique_lock<std::mutex> lock(error_mutex);
+                    if (!error)
+                        error = std::current_exception();
+                    next = files.size(); // don't start any more files
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        jobs = unsigned(std::min<std::size_t>(jobs, files.size()));
+        for (auto i = 1u; i < jobs; ++i)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& t : threads)
+            t.join();
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+} // namespace standardese_tool
+
+#endif // STANDARDESE_SCHEDULE_HPP_INCLUDED
@@ -0,0 +1,442 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_SERVER_HPP_INCLUDED
+#define STANDARDESE_SERVER_HPP_INCLUDED
+
+#if !defined(_WIN32)
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace standardese_tool
+{
+    // the requests and responses of the server are JSON objects with string values, one per line
+    using json_object = std::map<std::string, std::string>;
+
+    namespace detail
+    {
+        inline void append_utf8(std::string &str, unsigned long cp)
+        {
+            if (cp < 0x80)
+                str += char(cp);
+            else if (cp < 0x800)
+            {
+                str += char(0xC0 | (cp >> 6));
+                str += char(0x80 | (cp & 0x3F));
+            }
+            else if (cp < 0x10000)
+            {
+                str += char(0xE0 | (cp >> 12));
+                str += char(0x80 | ((cp >> 6) & 0x3F));
+                str += char(0x80 | (cp & 0x3F));
+            }
+            else
+            {
+                str += char(0xF0 | (cp >> 18));
+                str += char(0x80 | ((cp >> 12) & 0x3F));
+                str += char(0x80 | ((cp >> 6) & 0x3F));
+                str += char(0x80 | (cp & 0x3F));
+            }
+        }
+
+        class json_parser
+        {
+        public:
+            explicit json_parser(const std::string &str)
+            : str_(str), pos_(0u) {}
+
+            json_object parse_object()
+            {
+                json_object result;
+
+                expect('{');
+                if (!consume('}'))
+                {
+                    do
+                    {
+                        auto key = parse_string();
+                        expect(':');
+                        result[key] = parse_string();
+                    } while (consume(','));
+                    expect('}');
+                }
+
+                skip_ws();
+                if (pos_ != str_.size())
+                    throw error("unexpected characters after the object");
+                return result;
+            }
+
+        private:
+            std::invalid_argument error(const std::string &msg) const
+            {
+                return std::invalid_argument("invalid request: " + msg);
+            }
+
+            void skip_ws()
+            {
+                while (pos_ != str_.size()
+                       && (str_[pos_] == ' ' || str_[pos_] == '\t' || str_[pos_] == '\r' || str_[pos_] == '\n'))
+                    ++pos_;
+            }
+
+            bool consume(char c)
+            {
+                skip_ws();
+                if (pos_ == str_.size() || str_[pos_] != c)
+                    return false;
+                ++pos_;
+                return true;
+            }
+
+            void expect(char c)
+            {
+                if (!consume(c))
+                    throw error(std::string("expected '") + c + "'");
+            }
+
+            unsigned long parse_hex()
+            {
+                if (str_.size() - pos_ < 4u)
+                    throw error("invalid escape sequence");
+
+                unsigned long result = 0u;
+                for (auto end = pos_ + 4u; pos_ != end; ++pos_)
+                {
+                    auto c = str_[pos_];
+                    result *= 16u;
+                    if (c >= '0' && c <= '9')
+                        result += unsigned(c - '0');
+                    else if (c >= 'a' && c <= 'f')
+                        result += unsigned(c - 'a' + 10);
+                    else if (c >= 'A' && c <= 'F')
+                        result += unsigned(c - 'A' + 10);
+                    else
+                        throw error("invalid escape sequence");
+                }
+                return result;
+            }
+
+            std::string parse_string()
+            {
+                // only strings are needed for the requests
+                expect('"');
+
+                std::string result;
+                while (true)
+                {
+                    if (pos_ == str_.size())
+                        throw error("unterminated string");
+
+                    auto c = str_[pos_++];
+                    if (c == '"')
+                        break;
+                    else if (c != '\\')
+                    {
+                        result += c;
+                        continue;
+                    }
+                    else if (pos_ == str_.size())
+                        throw error("unterminated string");
+
+                    switch (str_[pos_++])
+                    {
+                        case '"':
+                            result += '"';
+                            break;
+                        case '\\':
+                            result += '\\';
+                            break;
+                        case '/':
+                            result += '/';
+                            break;
+                        case 'b':
+                            result += '\b';
+                            break;
+                        case 'f':
+                            result += '\f';
+                            break;
+                        case 'n':
+                            result += '\n';
+                            break;
+                        case 'r':
+                            result += '\r';
+                            break;
+                        case 't':
+                            result += '\t';
+                            break;
+                        case 'u':
+                        {
+                            auto cp = parse_hex();
+                            if (cp >= 0xD800 && cp < 0xDC00 && str_.compare(pos_, 2, "\\u") == 0)
+                            {
+                                // surrogate pair
+                                pos_ += 2;
+                                auto low = parse_hex();
+                                if (low < 0xDC00 || low >= 0xE000)
+                                    throw error("invalid surrogate pair");
+                                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            }
+                            append_utf8(result, cp);
+                            break;
+                        }
+                        default:
+                            throw error("invalid escape sequence");
+                    }
+                }
+                return result;
+            }
+
+            const std::string &str_;
+            std::size_t pos_;
+        };
+    } // namespace detail
+
+    // throws std::invalid_argument if it isn't an object of strings
+    inline json_object parse_json_object(const std::string &str)
+    {
+        return detail::json_parser(str).parse_object();
+    }
+
+    inline std::string to_json(const json_object &object)
+    {
+        std::string result = "{";
+        auto append_string = [&](const std::string &str)
+        {
+            result += '"';
+            for (auto c : str)
+                switch (c)
+                {
+                    case '"':
+                        result += "\\\"";
+                        break;
+                    case '\\':
+                        result += "\\\\";
+                        break;
+                    case '\n':
+                        result += "\\n";
+                        break;
+                    case '\r':
+                        result += "\\r";
+                        break;
+                    case '\t':
+                        result += "\\t";
+                        break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20)
+                        {
+                            char buffer[8];
+                            std::snprintf(buffer, sizeof(buffer), "\\u%04x", unsigned(c));
+                            result += buffer;
+                        }
+                        else
+                            result += c;
+                        break;
+                }
+            result += '"';
+        };
+
+        for (auto& member : object)
+        {
+            if (result.size() != 1u)
+                result += ',';
+            append_string(member.first);
+            result += ':';
+            append_string(member.second);
+        }
+        return result + '}';
+    }
+
+    // accepts connections on a Unix domain socket and answers each line with a line
+    // the requests are handled one at a time, in the order they arrive
+    class unix_server
+    {
+    public:
+        // returns the response to a request, without the newline
+        using handler = std::function<std::string(const std::string &)>;
+
+        // a client whose request is longer gets an error and is disconnected,
+        // so it cannot make the server buffer an unbounded line
+        static const std::size_t max_request_size = 1024u * 1024u;
+
+        // throws std::runtime_error if it cannot listen on path
+        explicit unix_server(std::string path)
+        : path_(std::move(path)), fd_(-1), running_(false)
+        {
+            sockaddr_un addr;
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            if (path_.size() >= sizeof(addr.sun_path))
+                throw std::runtime_error("socket path '" + path_ + "' is too long");
+            std::strcpy(addr.sun_path, path_.c_str());
+
+            // a socket left by an earlier server that wasn't shut down
+            struct stat info;
+            if (::stat(path_.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+                ::unlink(path_.c_str());
+
+            fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd_ == -1)
+                throw error("unable to create socket");
+            if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+            {
+                auto ex = error("unable to bind socket");
+                ::close(fd_);
+                throw ex;
+            }
+            if (::listen(fd_, 16) != 0)
+            {
+                auto ex = error("unable to listen on socket");
+                ::close(fd_);
+                ::unlink(path_.c_str());
+                throw ex;
+            }
+
+            // a client can disconnect before reading its response
+            std::signal(SIGPIPE, SIG_IGN);
+        }
+
+        unix_server(const unix_server &) = delete;
+        unix_server &operator=(const unix_server &) = delete;
+
+        ~unix_server()
+        {
+            for (auto& c : clients_)
+                ::close(c.fd);
+            ::close(fd_);
+            ::unlink(path_.c_str());
+        }
+
+        // serves requests until stop() is called
+        void run(const handler &h)
+        {
+            running_ = true;
+            while (running_)
+            {
+                std::vector<pollfd> fds;
+                fds.push_back(pollfd{fd_, POLLIN, 0});
+                for (auto& c : clients_)
+                    fds.push_back(pollfd{c.fd, POLLIN, 0});
+
+                if (::poll(fds.data(), fds.size(), -1) == -1)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    throw error("unable to wait for requests");
+                }
+
+                for (std::size_t i = 1u; i != fds.size() && running_; ++i)
+                    if (fds[i].revents != 0 && !serve(clients_[i - 1], h))
+                    {
+                        ::close(clients_[i - 1].fd);
+                        clients_[i - 1].fd = -1;
+                    }
+                clients_.erase(std::remove_if(clients_.begin(), clients_.end(),
+                                              [](const client &c) {return c.fd == -1;}),
+                               clients_.end());
+
+                if (fds[0].revents != 0)
+                {
+                    auto fd = ::accept(fd_, nullptr, nullptr);
+                    if (fd != -1)
+                        clients_.push_back(client{fd, ""});
+                }
+            }
+        }
+
+        void stop()
+        {
+            running_ = false;
+        }
+
+    private:
+        struct client
+        {
+            int fd;
+            std::string buffer;
+        };
+
+        std::runtime_error error(const std::string &msg) const
+        {
+            return std::runtime_error(msg + " '" + path_ + "': " + std::strerror(errno));
+        }
+
+        // returns false if the connection is closed
+        bool serve(client &c, const handler &h)
+        {
+            char data[4096];
+            auto n = ::read(c.fd, data, sizeof(data));
+            if (n == -1 && errno == EINTR)
+                return true;
+            else if (n <= 0)
+                return false;
+            c.buffer.append(data, std::size_t(n));
+
+            for (auto newline = c.buffer.find('\n'); newline != std::string::npos && running_;
+                 newline = c.buffer.find('\n'))
+            {
+                auto request = c.buffer.substr(0, newline);
+                c.buffer.erase(0, newline + 1);
+                if (request.empty())
+                    continue;
+                else if (request.size() > max_request_size)
+                    return send_too_long(c);
+                else if (!send(c, h(request)))
+                    return false;
+            }
+
+            if (c.buffer.size() > max_request_size)
+                return send_too_long(c);
+            return true;
+        }
+
+        // returns false if the response couldn't be written
+        bool send(const client &c, const std::string &response)
+        {
+            auto line = response + '\n';
+            for (auto ptr = line.data(); ptr != line.data() + line.size();)
+            {
+                auto written = ::write(c.fd, ptr, std::size_t(line.data() + line.size() - ptr));
+                if (written == -1 && errno == EINTR)
+                    continue;
+                else if (written <= 0)
+                    return false;
+                ptr += written;
+            }
+            return true;
+        }
+
+        // always returns false, the connection is closed afterwards
+        bool send_too_long(const client &c)
+        {
+            send(c, to_json({{"status", "error"},
+                             {"message", "request longer than " + std::to_string(max_request_size) + " bytes"}}));
+            return false;
+        }
+
+        std::string path_;
+        int fd_;
+        std::vector<client> clients_;
+        bool running_;
+    };
+} // namespace standardese_tool
+
+#endif // !defined(_WIN32)
+
+#endif // STANDARDESE_SERVER_HPP_INCLUDED
@@ -0,0 +1,237 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_SHARD_HPP_INCLUDED
+#define STANDARDESE_SHARD_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <standardese/cpp_entity.hpp>
+#include <standardese/cpp_type.hpp>
+#include <standardese/parser.hpp>
+
+namespace standardese_tool
+{
+    namespace fs = boost::filesystem;
+
+    // one of count machines processing the inputs
+    struct shard
+    {
+        unsigned index, count;
+    };
+
+    // parses "i/N", i is zero-based
+    inline shard parse_shard(const std::string &str)
+    {
+        auto error = [&]
+        {
+            return std::invalid_argument("invalid shard '" + str + "', expected 'i/N' with i < N");
+        };
+
+        auto sep = str.find('/');
+        if (sep == std::string::npos || sep == 0u || sep + 1 == str.size()
+            || str.find_first_not_of("0123456789/") != std::string::npos
+            || str.find('/', sep + 1) != std::string::npos)
+            throw error();
+
+        shard result;
+        try
+        {
+            result.index = unsigned(std::stoul(str.substr(0, sep)));
+            result.count = unsigned(std::stoul(str.substr(sep + 1)));
+        }
+        catch (std::out_of_range&)
+        {
+            throw error();
+        }
+
+        if (result.count == 0u || result.index >= result.count)
+            throw error();
+        return result;
+    }
+
+    // returns the files processed by the given shard
+    // all machines see the same files, so they compute the same assignment:
+    // the largest file goes to the shard with the least work so far,
+    // using the file size as the estimated cost
+    inline std::vector<fs::path> select_shard(const std::vector<fs::path> &files, shard s)
+    {
+        // the cost and the index of each file
+        using entry = std::pair<std::uintmax_t, std::size_t>;
+        std::vector<entry> costs;
+        costs.reserve(files.size());
+        for (std::size_t i = 0u; i != files.size(); ++i)
+        {
+            boost::system::error_code ec;
+            auto size = fs::file_size(files[i], ec);
+            costs.emplace_back(ec ? 0u : size, i);
+        }
+        // largest first, ties broken by path
+        std::sort(costs.begin(), costs.end(),
+                  [&](const entry &a, const entry &b)
+                  {
+                      return a.first != b.first ? a.first > b.first
+                                                : files[a.second].generic_string() < files[b.second].generic_string();
+                  });
+
+        std::vector<std::uintmax_t> load(s.count, 0u);
+        std::vector<bool> selected(files.size(), false);
+        for (auto& cost : costs)
+        {
+            auto min = std::min_element(load.begin(), load.end());
+            *min += cost.first + 1u; // every file has some cost
+            if (std::size_t(min - load.begin()) == s.index)
+                selected[cost.second] = true;
+        }
+
+        // keep the original order
+        std::vector<fs::path> result;
+        for (std::size_t i = 0u; i != files.size(); ++i)
+            if (selected[i])
+                result.push_back(files[i]);
+        return result;
+    }
+
+    // the registries of the parsers, i.e. all namespaces and types and the files they are in
+    // each shard writes its own, they are combined by the merge step
+    class entity_index
+    {
+    public:
+        // adds the registries of the parser
+        void add(standardese::parser &p)
+        {
+            p.for_each_namespace([&](const standardese::cpp_name &name)
+                                 {
+                                     namespaces_.insert(name);
+                                 });
+            p.for_each_type([&](const standardese::cpp_type &t)
+                            {
+                                types_[t.get_unique_name()] = get_file(t);
+                            });
+        }
+
+        // adds another index
+        void add(const entity_index &other)
+        {
+            namespaces_.insert(other.namespaces_.begin(), other.namespaces_.end());
+            for (auto& t : other.types_)
+                types_.insert(t);
+        }
+
+        std::size_t no_namespaces() const
+        {
+            return namespaces_.size();
+        }
+
+        std::size_t no_types() const
+        {
+            return types_.size();
+        }
+
+        // adds an entry written by write_entries(),
+        // returns false if it is invalid
+        bool add_entry(const std::string &line)
+        {
+            auto sep = line.find(' ');
+            if (sep == std::string::npos)
+                return false;
+
+            auto key = line.substr(0, sep);
+            if (key == "namespace")
+                namespaces_.insert(line.substr(sep + 1));
+            else if (key == "type")
+            {
+                auto tab = line.find('\t', sep + 1);
+                if (tab == std::string::npos)
+                    return false;
+                types_[line.substr(sep + 1, tab - sep - 1)] = line.substr(tab + 1);
+            }
+            else
+                return false;
+            return true;
+        }
+
+        // writes all entries that aren't in except, one per line
+        void write_entries(std::ostream &out, const entity_index &except = {}) const
+        {
+            for (auto& name : namespaces_)
+                if (!except.namespaces_.count(name))
+                    out << "namespace " << name << '\n';
+            for (auto& t : types_)
+                if (!except.types_.count(t.first))
+                    out << "type " << t.first << '\t' << t.second << '\n';
+        }
+
+        // throws std::runtime_error if the file cannot be read or is invalid
+        void read(const fs::path &path)
+        {
+            fs::ifstream in(path);
+            std::string line;
+            if (!in || !std::getline(in, line) || line != "standardese-index 1")
+                throw std::runtime_error("invalid index file '" + path.generic_string() + "'");
+
+            while (std::getline(in, line))
+                if (!add_entry(line))
+                    throw std::runtime_error("invalid index file '" + path.generic_string() + "'");
+        }
+
+        void write(const fs::path &path) const
+        {
+            fs::ofstream out(path);
+            out << "standardese-index 1\n";
+            write_entries(out);
+            if (!out)
+                throw std::runtime_error("unable to write index file '" + path.generic_string() + "'");
+        }
+
+    private:
+        static std::string get_file(const standardese::cpp_entity &e)
+        {
+            auto cur = &e;
+            while (cur->get_parent())
+                cur = cur->get_parent();
+            return cur->get_entity_type() == standardese::cpp_entity::file_t ? cur->get_name() : "";
+        }
+
+        std::set<std::string> namespaces_;
+        std::map<std::string, std::string> types_;
+    };
+
+    inline fs::path get_shard_index_path(shard s)
+    {
+        return "standardese-shard-" + std::to_string(s.index) + "-of-" + std::to_string(s.count) + ".index";
+    }
+
+    // combines the indices of all shards into one,
+    // throws std::runtime_error if one is missing
+    inline entity_index merge_shards(unsigned count)
+    {
+        entity_index result;
+        for (auto i = 0u; i != count; ++i)
+        {
+            auto path = get_shard_index_path(shard{i, count});
+            if (!fs::exists(path))
+                throw std::runtime_error("index of shard " + std::to_string(i) + '/' + std::to_string(count)
+                                         + " not found ('" + path.generic_string() + "')");
+
+            entity_index index;
+            index.read(path);
+            result.add(index);
+        }
+        return result;
+    }
+} // namespace standardese_tool
+
+#endif // STANDARDESE_SHARD_HPP_INCLUDED
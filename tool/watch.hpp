@@ -0,0 +1,131 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_WATCH_HPP_INCLUDED
+#define STANDARDESE_WATCH_HPP_INCLUDED
+
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#if defined(__linux__)
+    #include <cerrno>
+    #include <cstring>
+    #include <map>
+    #include <set>
+    #include <stdexcept>
+
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace standardese_tool
+{
+    namespace fs = boost::filesystem;
+
+    // returns the path used to identify a file, independent of the way it was given
+    inline std::string get_watch_path(const fs::path &file)
+    {
+        boost::system::error_code ec;
+        auto path = fs::canonical(file, ec);
+        return (ec ? fs::absolute(file) : path).generic_string();
+    }
+
+#if defined(__linux__)
+    // waits for changes of files using inotify
+    // the directories of the files are watched, as editors often replace a file instead of writing it
+    class file_watcher
+    {
+    public:
+        file_watcher()
+        : fd_(::inotify_init1(IN_CLOEXEC))
+        {
+            if (fd_ == -1)
+                throw std::runtime_error(std::string("unable to watch files: ") + std::strerror(errno));
+        }
+
+        file_watcher(const file_watcher &) = delete;
+        file_watcher &operator=(const file_watcher &) = delete;
+
+        ~file_watcher()
+        {
+            ::close(fd_);
+        }
+
+        void add_file(const fs::path &file)
+        {
+            auto path = get_watch_path(file);
+            if (!files_.insert(path).second)
+                return;
+
+            auto dir = fs::path(path).parent_path().generic_string();
+            if (!dirs_.insert(dir).second)
+                return;
+
+            auto wd = ::inotify_add_watch(fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+            if (wd == -1)
+                throw std::runtime_error("unable to watch directory '" + dir + "': " + std::strerror(errno));
+            watches_[wd] = dir;
+        }
+
+        std::size_t no_files() const
+        {
+            return files_.size();
+        }
+
+        // blocks until at least one of the files has changed and returns the paths of the changed ones
+        // the changes that follow within a short time are returned as well,
+        // so saving multiple files at once is handled together
+        std::set<std::string> wait()
+        {
+            std::set<std::string> result;
+
+            auto timeout = -1;
+            while (true)
+            {
+                pollfd fd{fd_, POLLIN, 0};
+                auto res = ::poll(&fd, 1, timeout);
+                if (res == -1 && errno == EINTR)
+                    continue;
+                else if (res == -1)
+                    throw std::runtime_error(std::string("unable to watch files: ") + std::strerror(errno));
+                else if (res == 0)
+                    return result;
+
+                alignas(inotify_event) char buffer[4096];
+                auto n = ::read(fd_, buffer, sizeof(buffer));
+                if (n == -1 && errno == EINTR)
+                    continue;
+                else if (n <= 0)
+                    throw std::runtime_error(std::string("unable to watch files: ") + std::strerror(errno));
+
+                for (auto ptr = buffer; ptr < buffer + n;)
+                {
+                    auto event = reinterpret_cast<const inotify_event*>(ptr);
+                    ptr += sizeof(inotify_event) + event->len;
+
+                    auto iter = watches_.find(event->wd);
+                    if (event->len == 0u || iter == watches_.end())
+                        continue;
+
+                    auto path = iter->second + '/' + event->name;
+                    if (files_.count(path))
+                        result.insert(path);
+                }
+
+                if (!result.empty())
+                    timeout = 100;
+            }
+        }
+
+    private:
+        int fd_;
+        std::set<std::string> files_, dirs_;
+        std::map<int, std::string> watches_;
+    };
+#endif // defined(__linux__)
+} // namespace standardese_tool
+
+#endif // STANDARDESE_WATCH_HPP_INCLUDED
@@ -0,0 +1,322 @@
+// Copyright (C) 2016 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_WORKER_HPP_INCLUDED
+#define STANDARDESE_WORKER_HPP_INCLUDED
+
+#if !defined(_WIN32)
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace standardese_tool
+{
+    // a pool of forked processes that handle one request at a time
+    // a process that crashes only loses its current request and is replaced by a new one
+    // the processes are forked from the calling thread, no other thread must be running
+    // while the pool exists, receive() forks the replacement of a crashed process
+    class worker_pool
+    {
+    public:
+        // called in the worker process, returns the response
+        using handler = std::function<std::string(const std::string &)>;
+
+        struct result
+        {
+            std::string request;
+            // the response or the reason of the crash
+            std::string response;
+            bool crashed;
+        };
+
+        worker_pool(unsigned size, handler h)
+        : handler_(std::move(h))
+        {
+            // a worker can die before reading its request
+            std::signal(SIGPIPE, SIG_IGN);
+
+            workers_.resize(size == 0u ? 1u : size);
+            try
+            {
+                for (auto& w : workers_)
+                    start(w);
+            }
+            catch (...)
+            {
+                // the destructor isn't called, so the workers already started must be stopped here
+                stop();
+                throw;
+            }
+        }
+
+        worker_pool(const worker_pool &) = delete;
+        worker_pool &operator=(const worker_pool &) = delete;
+
+        ~worker_pool()
+        {
+            stop();
+        }
+
+        // returns whether a worker can take a request
+        bool idle() const
+        {
+            for (auto& w : workers_)
+                if (!w.busy)
+                    return true;
+            return false;
+        }
+
+        // sends the request to an idle worker
+        void send(std::string request)
+        {
+            for (auto& w : workers_)
+                if (!w.busy)
+                {
+                    w.busy = true;
+                    w.current = std::move(request);
+                    auto line = w.current + '\n';
+                    // if the worker died, it is noticed when waiting for the response
+                    write_all(w.request, line.data(), line.size());
+                    return;
+                }
+            throw std::logic_error("no idle worker");
+        }
+
+        // blocks until a busy worker has responded or crashed,
+        // returns false if no worker is busy
+        bool receive(result &r)
+        {
+            while (true)
+            {
+                std::vector<pollfd> fds;
+                std::vector<worker*> busy;
+                for (auto& w : workers_)
+                    if (w.busy)
+                    {
+                        fds.push_back(pollfd{w.response, POLLIN, 0});
+                        busy.push_back(&w);
+                    }
+                if (fds.empty())
+                    return false;
+
+                if (::poll(fds.data(), fds.size(), -1) == -1)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    throw std::runtime_error(std::string("unable to wait for workers: ") + std::strerror(errno));
+                }
+
+                for (std::size_t i = 0u; i != fds.size(); ++i)
+                {
+                    if (fds[i].revents == 0)
+                        continue;
+
+                    auto& w = *busy[i];
+                    char buffer[4096];
+                    auto n = ::read(w.response, buffer, sizeof(buffer));
+                    if (n > 0)
+                    {
+                        w.buffer.append(buffer, std::size_t(n));
+                        if (take_response(w, r))
+                            return true;
+                    }
+                    else if (n == 0 || errno != EINTR)
+                    {
+                        r.request = std::move(w.current);
+                        r.response = get_exit_reason(w.pid);
+                        r.crashed = true;
+
+                        // already reaped, so nothing is closed or waited for twice if start() throws
+                        ::close(w.request);
+                        ::close(w.response);
+                        w.request = w.response = -1;
+                        w.pid = -1;
+                        start(w);
+                        return true;
+                    }
+                }
+            }
+        }
+
+    private:
+        struct worker
+        {
+            pid_t pid = -1;
+            int request = -1, response = -1;
+            bool busy = false;
+            std::string current, buffer;
+        };
+
+        // stops the workers that are running
+        void stop()
+        {
+            // the workers exit once their request pipe is closed
+            for (auto& w : workers_)
+                if (w.request != -1)
+                {
+                    ::close(w.request);
+                    w.request = -1;
+                }
+            for (auto& w : workers_)
+            {
+                if (w.response != -1)
+                {
+                    ::close(w.response);
+                    w.response = -1;
+                }
+                if (w.pid != -1)
+                {
+                    ::waitpid(w.pid, nullptr, 0);
+                    w.pid = -1;
+                }
+            }
+        }
+
+        static bool write_all(int fd, const char *data, std::size_t size)
+        {
+            while (size != 0u)
+            {
+                auto n = ::write(fd, data, size);
+                if (n == -1 && errno == EINTR)
+                    continue;
+                else if (n <= 0)
+                    return false;
+                data += n;
+                size -= std::size_t(n);
+            }
+            return true;
+        }
+
+        // a response is its size in decimal, a newline and the data
+        static bool take_response(worker &w, result &r)
+        {
+            auto newline = w.buffer.find('\n');
+            if (newline == std::string::npos)
+                return false;
+            auto size = std::stoul(w.buffer.substr(0, newline));
+            if (w.buffer.size() - newline - 1 < size)
+                return false;
+
+            r.request = std::move(w.current);
+            r.response = w.buffer.substr(newline + 1, size);
+            r.crashed = false;
+            w.buffer.erase(0, newline + 1 + size);
+            w.busy = false;
+            return true;
+        }
+
+        static std::string get_exit_reason(pid_t pid)
+        {
+            int status;
+            while (::waitpid(pid, &status, 0) == -1)
+                if (errno != EINTR)
+                    return "worker process vanished";
+
+            if (WIFSIGNALED(status))
+                return std::string("worker process killed by signal ") + std::to_string(WTERMSIG(status))
+                     + " (" + ::strsignal(WTERMSIG(status)) + ")";
+            return "worker process exited with code " + std::to_string(WEXITSTATUS(status));
+        }
+
+        void start(worker &w)
+        {
+            int request[2], response[2];
+            if (::pipe(request) != 0)
+                throw std::runtime_error(std::string("unable to create pipe: ") + std::strerror(errno));
+            if (::pipe(response) != 0)
+            {
+                ::close(request[0]);
+                ::close(request[1]);
+                throw std::runtime_error(std::string("unable to create pipe: ") + std::strerror(errno));
+            }
+
+            auto pid = ::fork();
+            if (pid == -1)
+            {
+                for (auto fd : {request[0], request[1], response[0], response[1]})
+                    ::close(fd);
+                throw std::runtime_error(std::string("unable to start worker: ") + std::strerror(errno));
+            }
+            else if (pid == 0)
+            {
+                // the pipes of the other workers must be closed,
+                // otherwise they don't notice when the pool is destroyed
+                for (auto& other : workers_)
+                    if (&other != &w && other.pid != -1)
+                    {
+                        ::close(other.request);
+                        ::close(other.response);
+                    }
+                ::close(request[1]);
+                ::close(response[0]);
+                run(request[0], response[1]);
+            }
+
+            ::close(request[0]);
+            ::close(response[1]);
+            w.pid = pid;
+            w.request = request[1];
+            w.response = response[0];
+            w.busy = false;
+            w.current.clear();
+            w.buffer.clear();
+        }
+
+        // the loop of the worker process, never returns
+        void run(int in, int out)
+        {
+            std::string buffer;
+            while (true)
+            {
+                auto newline = buffer.find('\n');
+                if (newline == std::string::npos)
+                {
+                    char data[4096];
+                    auto n = ::read(in, data, sizeof(data));
+                    if (n == -1 && errno == EINTR)
+                        continue;
+                    else if (n <= 0)
+                        // pool destroyed, don't run any destructors of the parent's objects
+                        ::_exit(0);
+                    buffer.append(data, std::size_t(n));
+                    continue;
+                }
+
+                auto request = buffer.substr(0, newline);
+                buffer.erase(0, newline + 1);
+
+                std::string response;
+                try
+                {
+                    response = handler_(request);
+                }
+                catch (...)
+                {
+                    ::_exit(1);
+                }
+
+                auto message = std::to_string(response.size()) + '\n' + response;
+                if (!write_all(out, message.data(), message.size()))
+                    ::_exit(1);
+            }
+        }
+
+        handler handler_;
+        std::vector<worker> workers_;
+    };
+} // namespace standardese_tool
+
+#endif // !defined(_WIN32)
+
+#endif // STANDARDESE_WORKER_HPP_INCLUDED